@@ -1,6 +1,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
 
 #include "opentelemetry/nostd/shared_ptr.h"
 #include "opentelemetry/trace/noop.h"
@@ -11,6 +14,12 @@ namespace trace
 {
 /**
  * Stores the singleton global TracerProvider.
+ *
+ * Every thread caches its own reference to the TracerProvider, with its own
+ * reference count, together with the generation of the TracerProvider. Looking
+ * up an unchanged TracerProvider only reads the global generation and copies
+ * the thread's reference, so it takes no lock and doesn't write to memory
+ * shared with other threads.
  */
 class Provider
 {
@@ -23,26 +32,90 @@ class Provider
    */
   static nostd::shared_ptr<TracerProvider> GetTracerProvider() noexcept
   {
-    while (GetLock().test_and_set(std::memory_order_acquire))
-      ;
-    auto provider = nostd::shared_ptr<TracerProvider>(GetProvider());
-    GetLock().clear(std::memory_order_release);
-
-    return provider;
+    auto &cache = GetThreadCache();
+    if (cache.generation != GetGeneration().load(std::memory_order_acquire))
+    {
+      return RefreshThreadCache(cache);
+    }
+    return cache.provider;
   }
 
   /**
    * Changes the singleton TracerProvider.
+   *
+   * Note: Threads keep a reference to the previous TracerProvider until they
+   * look up the TracerProvider again, or exit.
    */
   static void SetTracerProvider(nostd::shared_ptr<TracerProvider> tp) noexcept
   {
     while (GetLock().test_and_set(std::memory_order_acquire))
       ;
     GetProvider() = tp;
+    GetGeneration().fetch_add(1, std::memory_order_release);
     GetLock().clear(std::memory_order_release);
   }
 
 private:
+  struct ThreadCache
+  {
+    uint64_t generation = 0;
+    nostd::shared_ptr<TracerProvider> provider;
+  };
+
+  /**
+   * Copy the global TracerProvider into the thread's cache.
+   * @return the global TracerProvider
+   */
+  static nostd::shared_ptr<TracerProvider> RefreshThreadCache(ThreadCache &cache) noexcept
+  {
+    while (GetLock().test_and_set(std::memory_order_acquire))
+      ;
+    nostd::shared_ptr<TracerProvider> provider{GetProvider()};
+    auto generation = GetGeneration().load(std::memory_order_relaxed);
+    GetLock().clear(std::memory_order_release);
+
+    if (CacheReference(cache, provider))
+    {
+      cache.generation = generation;
+    }
+    return provider;
+  }
+
+  /**
+   * Store a reference to provider in the thread's cache, which shares
+   * ownership of provider, but has a reference count of its own.
+   * @return true if the reference could be allocated. Otherwise, the cache is
+   * left as it is, and the next lookup tries again.
+   */
+  static bool CacheReference(ThreadCache &cache,
+                             const nostd::shared_ptr<TracerProvider> &provider) noexcept
+#if __EXCEPTIONS
+      try
+#endif
+  {
+    auto reference = std::make_shared<nostd::shared_ptr<TracerProvider>>(provider);
+    cache.provider = std::shared_ptr<TracerProvider>(reference, reference->get());
+    return true;
+  }
+#if __EXCEPTIONS
+  catch (const std::bad_alloc &)
+  {
+    return false;
+  }
+#endif
+
+  static ThreadCache &GetThreadCache() noexcept
+  {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  static std::atomic<uint64_t> &GetGeneration() noexcept
+  {
+    static std::atomic<uint64_t> generation{1};
+    return generation;
+  }
+
   static nostd::shared_ptr<TracerProvider> &GetProvider() noexcept
   {
     static nostd::shared_ptr<TracerProvider> provider(new NoopTracerProvider);
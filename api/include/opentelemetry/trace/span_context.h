@@ -0,0 +1,71 @@
+// Copyright 2020, OpenTelemetry Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "opentelemetry/trace/span_id.h"
+#include "opentelemetry/trace/trace_flags.h"
+#include "opentelemetry/trace/trace_id.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace trace
+{
+
+// SpanContext holds the part of a Span that's propagated to its children and
+// across process boundaries: the trace and span ids, and the trace flags.
+class SpanContext final
+{
+public:
+  // An invalid SpanContext.
+  SpanContext() noexcept = default;
+
+  SpanContext(TraceId trace_id,
+              SpanId span_id,
+              TraceFlags trace_flags,
+              bool is_remote = false) noexcept
+      : trace_id_(trace_id), span_id_(span_id), trace_flags_(trace_flags), is_remote_(is_remote)
+  {}
+
+  const TraceId &trace_id() const noexcept { return trace_id_; }
+
+  const SpanId &span_id() const noexcept { return span_id_; }
+
+  const TraceFlags &trace_flags() const noexcept { return trace_flags_; }
+
+  // Returns true if the SpanContext was propagated from another process.
+  bool IsRemote() const noexcept { return is_remote_; }
+
+  bool IsSampled() const noexcept { return trace_flags_.IsSampled(); }
+
+  // Returns true if both the TraceId and the SpanId are valid.
+  bool IsValid() const noexcept { return trace_id_.IsValid() && span_id_.IsValid(); }
+
+  bool operator==(const SpanContext &that) const noexcept
+  {
+    return trace_id_ == that.trace_id_ && span_id_ == that.span_id_ &&
+           trace_flags_ == that.trace_flags_ && is_remote_ == that.is_remote_;
+  }
+
+  bool operator!=(const SpanContext &that) const noexcept { return !(*this == that); }
+
+private:
+  TraceId trace_id_;
+  SpanId span_id_;
+  TraceFlags trace_flags_;
+  bool is_remote_ = false;
+};
+
+}  // namespace trace
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,56 @@
+#include "opentelemetry/trace/provider.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using opentelemetry::trace::Provider;
+
+const int kLookupsPerThread = 100000;
+
+void GetTracerProviderForThread()
+{
+  for (int i = 0; i < kLookupsPerThread; ++i)
+  {
+    benchmark::DoNotOptimize(Provider::GetTracerProvider());
+  }
+}
+
+void BM_GetTracerProvider(benchmark::State &state)
+{
+  while (state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(Provider::GetTracerProvider());
+  }
+}
+BENCHMARK(BM_GetTracerProvider);
+
+/**
+ * Looks up the TracerProvider kLookupsPerThread times on each of
+ * state.range(0) threads.
+ */
+void BM_GetTracerProviderThreads(benchmark::State &state)
+{
+  auto num_threads    = static_cast<int>(state.range(0));
+  int64_t num_lookups = 0;
+  while (state.KeepRunning())
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.emplace_back(GetTracerProviderForThread);
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+    num_lookups += num_threads * kLookupsPerThread;
+  }
+  state.SetItemsProcessed(num_lookups);
+}
+BENCHMARK(BM_GetTracerProviderThreads)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+}  // namespace
+BENCHMARK_MAIN();
@@ -1,6 +1,10 @@
 #include "opentelemetry/trace/provider.h"
 #include "opentelemetry/nostd/shared_ptr.h"
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 using opentelemetry::trace::Provider;
@@ -29,3 +33,47 @@ TEST(Provider, SetTracerProvider)
   Provider::SetTracerProvider(tf);
   ASSERT_EQ(tf, Provider::GetTracerProvider());
 }
+
+TEST(Provider, SetTracerProviderWhileCachedByOtherThread)
+{
+  auto first  = opentelemetry::nostd::shared_ptr<TracerProvider>(new TestProvider());
+  auto second = opentelemetry::nostd::shared_ptr<TracerProvider>(new TestProvider());
+  Provider::SetTracerProvider(first);
+
+  std::atomic<int> step{0};
+  std::thread thread{[&] {
+    EXPECT_EQ(first, Provider::GetTracerProvider());
+    step = 1;
+    while (step != 2)
+    {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(second, Provider::GetTracerProvider());
+  }};
+  while (step != 1)
+  {
+    std::this_thread::yield();
+  }
+  Provider::SetTracerProvider(second);
+  step = 2;
+  thread.join();
+}
+
+TEST(Provider, ReleasesPreviousTracerProvider)
+{
+  std::weak_ptr<TracerProvider> previous;
+  {
+    std::shared_ptr<TracerProvider> provider{new TestProvider()};
+    previous = provider;
+    Provider::SetTracerProvider(opentelemetry::nostd::shared_ptr<TracerProvider>(provider));
+  }
+  EXPECT_NE(nullptr, Provider::GetTracerProvider());
+
+  Provider::SetTracerProvider(
+      opentelemetry::nostd::shared_ptr<TracerProvider>(new TestProvider()));
+  EXPECT_FALSE(previous.expired());
+
+  // The reference cached by this thread is released on its next lookup.
+  Provider::GetTracerProvider();
+  EXPECT_TRUE(previous.expired());
+}
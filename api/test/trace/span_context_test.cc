@@ -0,0 +1,53 @@
+#include "opentelemetry/trace/span_context.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using opentelemetry::trace::SpanContext;
+using opentelemetry::trace::SpanId;
+using opentelemetry::trace::TraceFlags;
+using opentelemetry::trace::TraceId;
+
+constexpr uint8_t kTraceIdBuf[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+constexpr uint8_t kSpanIdBuf[]  = {1, 2, 3, 4, 5, 6, 7, 8};
+
+TEST(SpanContextTest, DefaultConstruction)
+{
+  SpanContext context;
+  EXPECT_FALSE(context.IsValid());
+  EXPECT_FALSE(context.IsSampled());
+  EXPECT_FALSE(context.IsRemote());
+  EXPECT_FALSE(context.trace_id().IsValid());
+  EXPECT_FALSE(context.span_id().IsValid());
+}
+
+TEST(SpanContextTest, Construction)
+{
+  TraceId trace_id{kTraceIdBuf};
+  SpanId span_id{kSpanIdBuf};
+  SpanContext context{trace_id, span_id, TraceFlags{TraceFlags::kIsSampled}, true};
+  EXPECT_TRUE(context.IsValid());
+  EXPECT_TRUE(context.IsSampled());
+  EXPECT_TRUE(context.IsRemote());
+  EXPECT_EQ(trace_id, context.trace_id());
+  EXPECT_EQ(span_id, context.span_id());
+}
+
+TEST(SpanContextTest, InvalidWithoutSpanId)
+{
+  SpanContext context{TraceId{kTraceIdBuf}, SpanId{}, TraceFlags{}};
+  EXPECT_FALSE(context.IsValid());
+}
+
+TEST(SpanContextTest, Comparison)
+{
+  SpanContext context{TraceId{kTraceIdBuf}, SpanId{kSpanIdBuf}, TraceFlags{}};
+  EXPECT_EQ(context, (SpanContext{TraceId{kTraceIdBuf}, SpanId{kSpanIdBuf}, TraceFlags{}}));
+  EXPECT_NE(context, SpanContext{});
+  EXPECT_NE(context, (SpanContext{TraceId{kTraceIdBuf}, SpanId{kSpanIdBuf},
+                                  TraceFlags{TraceFlags::kIsSampled}}));
+}
+
+}  // namespace
@@ -2,6 +2,7 @@
 
 #include "opentelemetry/sdk/trace/exporter.h"
 #include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/span_data_pool.h"
 
 #include <iostream>
 
@@ -13,7 +14,7 @@ class StdoutExporter final : public sdktrace::SpanExporter
 {
   std::unique_ptr<sdktrace::Recordable> MakeRecordable() noexcept
   {
-    return std::unique_ptr<sdktrace::Recordable>(new sdktrace::SpanData);
+    return pool_.MakeRecordable();
   }
 
   sdktrace::ExportResult Export(
@@ -21,8 +22,7 @@ class StdoutExporter final : public sdktrace::SpanExporter
   {
     for (auto &recordable : spans)
     {
-      auto span = std::unique_ptr<sdktrace::SpanData>(
-          static_cast<sdktrace::SpanData *>(recordable.release()));
+      auto span = static_cast<sdktrace::SpanData *>(recordable.get());
 
       if (span != nullptr)
       {
@@ -43,10 +43,14 @@ class StdoutExporter final : public sdktrace::SpanExporter
                   << "\n  duration      : " << span->GetDuration().count() << "\n}"
                   << "\n";
       }
+      pool_.Recycle(std::move(recordable));
     }
 
     return sdktrace::ExportResult::kSuccess;
   }
 
   void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept {}
+
+private:
+  sdktrace::SpanDataPool pool_;
 };
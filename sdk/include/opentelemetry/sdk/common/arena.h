@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "opentelemetry/nostd/span.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * A bump allocator for data that is freed all at once.
+ *
+ * Memory is first taken from an initial block supplied by the owner, which is
+ * typically stored inline next to the arena. Once it's used up, blocks of
+ * growing size are allocated from the heap. Nothing is freed individually;
+ * Reset and the destructor release everything at once.
+ *
+ * Only trivially destructible objects may be placed in an arena, since their
+ * destructors are never run.
+ *
+ * This class is thread-compatible.
+ */
+class Arena
+{
+public:
+  /**
+   * @param initial_block the memory to allocate from first. It's not owned by
+   * the arena and must outlive it.
+   * @param initial_size the size of initial_block in bytes
+   */
+  Arena(char *initial_block, size_t initial_size) noexcept
+      : initial_block_{initial_block},
+        initial_size_{initial_size},
+        position_{initial_block},
+        end_{initial_block + initial_size}
+  {}
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  ~Arena() { FreeBlocks(); }
+
+  /**
+   * Allocate memory from the arena.
+   * @param size the number of bytes to allocate
+   * @param alignment the alignment of the memory; it must be a power of two
+   * no larger than alignof(std::max_align_t)
+   * @return the allocated memory, or nullptr if a new block couldn't be
+   * allocated
+   */
+  void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept
+  {
+    auto address = reinterpret_cast<uintptr_t>(position_);
+    auto padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+    if (padding + size > static_cast<size_t>(end_ - position_))
+    {
+      if (!AddBlock(size))
+      {
+        return nullptr;
+      }
+      padding = 0;
+    }
+    auto result = position_ + padding;
+    position_   = result + size;
+    return result;
+  }
+
+  /**
+   * Copy a string into the arena.
+   * @return a view of the copy, or an empty view if memory couldn't be
+   * allocated
+   */
+  nostd::string_view CopyString(nostd::string_view s) noexcept
+  {
+    if (s.empty())
+    {
+      return {};
+    }
+    auto data = static_cast<char *>(Allocate(s.size(), 1));
+    if (data == nullptr)
+    {
+      return {};
+    }
+    std::memcpy(data, s.data(), s.size());
+    return nostd::string_view{data, s.size()};
+  }
+
+  /**
+   * Copy an array of trivially copyable elements into the arena.
+   * @return a view of the copy, or an empty view if memory couldn't be
+   * allocated
+   */
+  template <class T>
+  nostd::span<const T> CopySpan(nostd::span<const T> values) noexcept
+  {
+    if (values.empty())
+    {
+      return {};
+    }
+    auto data = static_cast<T *>(Allocate(values.size() * sizeof(T), alignof(T)));
+    if (data == nullptr)
+    {
+      return {};
+    }
+    std::memcpy(data, values.data(), values.size() * sizeof(T));
+    return nostd::span<const T>{data, values.size()};
+  }
+
+  /**
+   * Release all memory allocated from the arena. Heap blocks are freed and
+   * allocation starts over at the initial block.
+   */
+  void Reset() noexcept
+  {
+    FreeBlocks();
+    position_ = initial_block_;
+    end_      = initial_block_ + initial_size_;
+  }
+
+  /**
+   * @return the number of heap blocks allocated since the arena was created or
+   * last reset
+   */
+  size_t GetNumBlocks() const noexcept
+  {
+    size_t result = 0;
+    for (auto block = blocks_; block != nullptr; block = block->next)
+    {
+      ++result;
+    }
+    return result;
+  }
+
+private:
+  struct alignas(std::max_align_t) Block
+  {
+    Block *next;
+    size_t size;
+  };
+
+  char *initial_block_;
+  size_t initial_size_;
+  char *position_;
+  char *end_;
+  Block *blocks_{nullptr};
+
+  bool AddBlock(size_t min_size) noexcept
+  {
+    // Each block is at least twice as large as the previous one, so the number
+    // of blocks stays logarithmic in the amount of data.
+    size_t size = std::max(initial_size_, static_cast<size_t>(256));
+    if (blocks_ != nullptr)
+    {
+      size = 2 * blocks_->size;
+    }
+    size      = std::max(size, min_size);
+    auto data = new (std::nothrow) char[sizeof(Block) + size];
+    if (data == nullptr)
+    {
+      return false;
+    }
+    auto block  = new (data) Block{blocks_, size};
+    blocks_     = block;
+    position_   = data + sizeof(Block);
+    end_        = position_ + size;
+    return true;
+  }
+
+  void FreeBlocks() noexcept
+  {
+    while (blocks_ != nullptr)
+    {
+      auto next = blocks_->next;
+      delete[] reinterpret_cast<char *>(blocks_);
+      blocks_ = next;
+    }
+  }
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,56 +1,289 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include "opentelemetry/sdk/common/thread_number.h"
 #include "opentelemetry/version.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
 {
+namespace detail
+{
+/**
+ * A hazard pointer: the node of an AtomicSharedPtr that a thread is reading.
+ * Every thread owns one record, which goes back to a shared list when the
+ * thread exits, so that later threads reuse it. Records are never freed.
+ */
+struct HazardRecord
+{
+  std::atomic<const void *> pointer{nullptr};
+  std::atomic<bool> is_active{true};
+  HazardRecord *next{nullptr};
+  // Every record is written by its own thread only.
+  char padding[64];
+};
+
+inline std::atomic<HazardRecord *> &GetHazardRecords() noexcept
+{
+  static std::atomic<HazardRecord *> head{nullptr};
+  return head;
+}
+
+/**
+ * @return a record that no other thread uses, or nullptr if none could be
+ * allocated
+ */
+inline HazardRecord *AcquireHazardRecord() noexcept
+{
+  auto &head = GetHazardRecords();
+  for (auto record = head.load(std::memory_order_acquire); record != nullptr;
+       record      = record->next)
+  {
+    bool is_active = false;
+    if (!record->is_active.load(std::memory_order_relaxed) &&
+        record->is_active.compare_exchange_strong(is_active, true, std::memory_order_acquire))
+    {
+      return record;
+    }
+  }
+  auto record = new (std::nothrow) HazardRecord;
+  if (record == nullptr)
+  {
+    return nullptr;
+  }
+  record->next = head.load(std::memory_order_relaxed);
+  while (!head.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                     std::memory_order_relaxed))
+  {
+  }
+  return record;
+}
+
 /**
- * A wrapper to provide atomic shared pointers.
+ * @return the hazard record of the calling thread, or nullptr if none could be
+ * allocated
+ */
+inline HazardRecord *GetHazardRecord() noexcept
+{
+  struct Owner
+  {
+    HazardRecord *record = AcquireHazardRecord();
+
+    ~Owner()
+    {
+      if (record != nullptr)
+      {
+        record->pointer.store(nullptr, std::memory_order_relaxed);
+        record->is_active.store(false, std::memory_order_release);
+        // Readers running in later thread-local destructors fall back to
+        // the mutex.
+        record = nullptr;
+      }
+    }
+  };
+  static thread_local Owner owner;
+  return owner.record;
+}
+
+/**
+ * @return true if a thread is reading ptr
+ */
+inline bool IsHazard(const void *ptr) noexcept
+{
+  for (auto record = GetHazardRecords().load(std::memory_order_acquire); record != nullptr;
+       record      = record->next)
+  {
+    if (record->pointer.load(std::memory_order_seq_cst) == ptr)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace detail
+
+/**
+ * A wrapper to provide atomic shared pointers that is optimized for reading.
  *
- * This wrapper relies on a mutex for gcc 4.8, and specializations of
- * std::atomic_store and std::atomic_load for all other instances.
+ * Copying a std::shared_ptr increments a reference count shared by all
+ * threads, and std::atomic_load additionally takes a lock from a global pool.
+ * Instead, the value is held by a node, and threads copy it through one of
+ * kNumSlots references in the node. Every reference has its own reference
+ * count, so threads assigned to different slots don't write to the same cache
+ * lines. The references are created on first use.
+ *
+ * load takes no lock: a reader announces the node it's about to read in its
+ * hazard pointer, and store only releases the references of a replaced node
+ * once no reader announces it anymore. Apart from copying the reference,
+ * a reader only writes to its own hazard pointer.
+ *
+ * store is slow: it takes a mutex, and waits for the readers of the previous
+ * node, which only hold their hazard pointers for a few instructions. Two
+ * nodes are enough, since the previous node is free again once store returns.
+ * The previous value is then only kept alive by the copies returned from
+ * load.
  */
-#if (__GNUC__ == 4 && (__GNUC_MINOR__ >= 8))
 template <class T>
 class AtomicSharedPtr
 {
 public:
-  explicit AtomicSharedPtr(std::shared_ptr<T> ptr) noexcept : ptr_{std::move(ptr)} {}
+  explicit AtomicSharedPtr(std::shared_ptr<T> ptr) noexcept { nodes_[0].ptr = std::move(ptr); }
+
+  ~AtomicSharedPtr()
+  {
+    for (auto &node : nodes_)
+    {
+      for (auto &reference : node.references)
+      {
+        delete reference.load(std::memory_order_relaxed);
+      }
+    }
+  }
 
   void store(const std::shared_ptr<T> &other) noexcept
   {
-    std::lock_guard<std::mutex> lock_guard{mu_};
-    ptr_ = other;
+    std::shared_ptr<T> previous;
+    std::shared_ptr<T> *previous_references[kNumSlots];
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      auto current = current_.load(std::memory_order_relaxed);
+      auto next    = current == &nodes_[0] ? &nodes_[1] : &nodes_[0];
+      next->ptr    = other;
+      current_.store(next, std::memory_order_seq_cst);
+
+      while (detail::IsHazard(current))
+      {
+        std::this_thread::yield();
+      }
+      std::swap(previous, current->ptr);
+      for (size_t i = 0; i < kNumSlots; ++i)
+      {
+        previous_references[i] =
+            current->references[i].exchange(nullptr, std::memory_order_relaxed);
+      }
+    }
+    // The previous value is destroyed here at the earliest, without holding
+    // any lock.
+    for (auto reference : previous_references)
+    {
+      delete reference;
+    }
   }
 
   std::shared_ptr<T> load() const noexcept
   {
-    std::lock_guard<std::mutex> lock_guard{mu_};
-    return ptr_;
+    auto record = detail::GetHazardRecord();
+    if (record == nullptr)
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      return current_.load(std::memory_order_relaxed)->ptr;
+    }
+
+    auto node = current_.load(std::memory_order_acquire);
+    while (true)
+    {
+      record->pointer.store(node, std::memory_order_seq_cst);
+      // If the node is still current, store can't release it before the
+      // hazard pointer is cleared.
+      auto current = current_.load(std::memory_order_seq_cst);
+      if (current == node)
+      {
+        break;
+      }
+      node = current;
+    }
+    auto result = node->GetReference(common::GetThreadNumber() % kNumSlots);
+    record->pointer.store(nullptr, std::memory_order_release);
+    return result;
   }
 
 private:
-  std::shared_ptr<T> ptr_;
-  mutable std::mutex mu_;
-};
-#else
-template <class T>
-class AtomicSharedPtr
-{
-public:
-  explicit AtomicSharedPtr(std::shared_ptr<T> ptr) noexcept : ptr_{std::move(ptr)} {}
+  static const size_t kNumSlots      = 16;
+  static const size_t kCacheLineSize = 64;
 
-  void store(const std::shared_ptr<T> &other) noexcept { std::atomic_store(&ptr_, other); }
+  /**
+   * Holds a slot's reference to the value. It's allocated together with the
+   * reference count of the slot, and padded so that the reference counts of
+   * different slots don't share a cache line.
+   */
+  struct SlotReference
+  {
+    std::shared_ptr<T> ptr;
+    char padding[kCacheLineSize];
+  };
 
-  std::shared_ptr<T> load() const noexcept { return std::atomic_load(&ptr_); }
+  struct Node
+  {
+    std::shared_ptr<T> ptr;
+    mutable std::atomic<std::shared_ptr<T> *> references[kNumSlots];
 
-private:
-  std::shared_ptr<T> ptr_;
-};
+    Node() noexcept
+    {
+      for (auto &reference : references)
+      {
+        reference.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    std::shared_ptr<T> GetReference(size_t slot) const noexcept
+    {
+      auto reference = references[slot].load(std::memory_order_acquire);
+      if (reference != nullptr)
+      {
+        return *reference;
+      }
+      if (ptr == nullptr)
+      {
+        return nullptr;
+      }
+      reference = CreateReference();
+      if (reference == nullptr)
+      {
+        // Share the value's reference count rather than fail.
+        return ptr;
+      }
+      std::shared_ptr<T> *expected = nullptr;
+      if (!references[slot].compare_exchange_strong(expected, reference,
+                                                    std::memory_order_acq_rel,
+                                                    std::memory_order_acquire))
+      {
+        delete reference;
+        reference = expected;
+      }
+      return *reference;
+    }
+
+    /**
+     * @return a reference to ptr with a reference count of its own, or
+     * nullptr if it couldn't be allocated
+     */
+    std::shared_ptr<T> *CreateReference() const noexcept
+#if __EXCEPTIONS
+        try
 #endif
+    {
+      auto slot_reference = std::make_shared<SlotReference>();
+      slot_reference->ptr = ptr;
+      return new std::shared_ptr<T>{slot_reference, ptr.get()};
+    }
+#if __EXCEPTIONS
+    catch (const std::bad_alloc &)
+    {
+      return nullptr;
+    }
+#endif
+  };
+
+  Node nodes_[2];
+  std::atomic<Node *> current_{&nodes_[0]};
+  mutable std::mutex mutex_;
+};
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
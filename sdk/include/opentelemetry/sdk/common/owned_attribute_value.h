@@ -0,0 +1,334 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/nostd/span.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/nostd/variant.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * An attribute value that owns its strings and arrays.
+ *
+ * opentelemetry::common::AttributeValue refers to strings and arrays owned by
+ * the caller, so it can't be stored beyond the call it was passed to.
+ * OwnedAttributeValue copies them when it's constructed. Strings and arrays of
+ * up to kInlineSize bytes are stored inline; larger ones, and arrays of
+ * strings, take a single heap allocation.
+ *
+ * An OwnedAttributeValue is no larger than an AttributeValue.
+ */
+class OwnedAttributeValue
+{
+public:
+  /**
+   * The maximum size in bytes of strings and arrays stored inline.
+   */
+  static const size_t kInlineSize = 22;
+
+  OwnedAttributeValue() noexcept : OwnedAttributeValue(false) {}
+
+  /**
+   * Copy an attribute value.
+   * @param value the value to copy
+   *
+   * Note: If memory for a string or an array can't be allocated, the value
+   * becomes an empty string or array.
+   */
+  OwnedAttributeValue(const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    Assign(value);
+  }
+
+  OwnedAttributeValue(const OwnedAttributeValue &other) noexcept { Assign(other.Get()); }
+
+  OwnedAttributeValue(OwnedAttributeValue &&other) noexcept { Take(other); }
+
+  OwnedAttributeValue &operator=(const OwnedAttributeValue &other) noexcept
+  {
+    if (this != &other)
+    {
+      Free();
+      Assign(other.Get());
+    }
+    return *this;
+  }
+
+  OwnedAttributeValue &operator=(OwnedAttributeValue &&other) noexcept
+  {
+    if (this != &other)
+    {
+      Free();
+      Take(other);
+    }
+    return *this;
+  }
+
+  OwnedAttributeValue &operator=(const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    // The value may be a view of this value's own string or array, so it's
+    // copied before the current data is freed.
+    OwnedAttributeValue copy{value};
+    Free();
+    Take(copy);
+    return *this;
+  }
+
+  ~OwnedAttributeValue() { Free(); }
+
+  /**
+   * @return the index of the value's alternative in AttributeValue
+   */
+  size_t index() const noexcept { return type_; }
+
+  /**
+   * @return a view of this value. Strings and arrays in the view stay valid
+   * until this value is modified or destroyed.
+   */
+  opentelemetry::common::AttributeValue Get() const noexcept
+  {
+    switch (type_)
+    {
+      case kBool:
+        return GetScalar<bool>();
+      case kInt:
+        return GetScalar<int>();
+      case kInt64:
+        return GetScalar<int64_t>();
+      case kUInt:
+        return GetScalar<unsigned int>();
+      case kUInt64:
+        return GetScalar<uint64_t>();
+      case kDouble:
+        return GetScalar<double>();
+      case kString:
+        return nostd::string_view{GetBytes(), GetSize()};
+      case kBoolArray:
+        return GetArray<bool>();
+      case kIntArray:
+        return GetArray<int>();
+      case kInt64Array:
+        return GetArray<int64_t>();
+      case kUIntArray:
+        return GetArray<unsigned int>();
+      case kUInt64Array:
+        return GetArray<uint64_t>();
+      case kDoubleArray:
+        return GetArray<double>();
+      default:
+        return GetArray<nostd::string_view>();
+    }
+  }
+
+private:
+  // The alternatives of AttributeValue, in order.
+  enum Type : uint8_t
+  {
+    kBool,
+    kInt,
+    kInt64,
+    kUInt,
+    kUInt64,
+    kDouble,
+    kString,
+    kBoolArray,
+    kIntArray,
+    kInt64Array,
+    kUIntArray,
+    kUInt64Array,
+    kDoubleArray,
+    kStringArray
+  };
+
+  // Marks a value whose data is on the heap. data_ then holds the pointer to
+  // the data followed by its size: the number of strings for string arrays,
+  // and the number of bytes otherwise.
+  static const uint8_t kOnHeap = 0xff;
+
+  alignas(8) char data_[kInlineSize];
+  uint8_t type_;
+  // The number of bytes stored inline, or kOnHeap.
+  uint8_t size_;
+
+  const char *GetBytes() const noexcept
+  {
+    if (size_ != kOnHeap)
+    {
+      return data_;
+    }
+    const char *result;
+    std::memcpy(&result, data_, sizeof(result));
+    return result;
+  }
+
+  size_t GetSize() const noexcept
+  {
+    if (size_ != kOnHeap)
+    {
+      return size_;
+    }
+    size_t result;
+    std::memcpy(&result, data_ + sizeof(char *), sizeof(result));
+    return result;
+  }
+
+  template <class T>
+  T GetScalar() const noexcept
+  {
+    T result;
+    std::memcpy(&result, data_, sizeof(T));
+    return result;
+  }
+
+  template <class T>
+  nostd::span<const T> GetArray() const noexcept
+  {
+    auto size = type_ == kStringArray ? GetSize() : GetSize() / sizeof(T);
+    return nostd::span<const T>{reinterpret_cast<const T *>(GetBytes()), size};
+  }
+
+  template <class T>
+  void AssignScalar(Type type, T value) noexcept
+  {
+    type_ = type;
+    size_ = sizeof(T);
+    std::memcpy(data_, &value, sizeof(T));
+  }
+
+  void AssignBytes(Type type, const void *bytes, size_t size) noexcept
+  {
+    type_ = type;
+    size_ = 0;
+    if (size <= kInlineSize)
+    {
+      size_ = static_cast<uint8_t>(size);
+      if (size > 0)
+      {
+        std::memcpy(data_, bytes, size);
+      }
+      return;
+    }
+    auto heap_bytes = new (std::nothrow) char[size];
+    if (heap_bytes != nullptr)
+    {
+      std::memcpy(heap_bytes, bytes, size);
+      SetHeap(heap_bytes, size);
+    }
+  }
+
+  template <class T>
+  void AssignArray(Type type, nostd::span<const T> values) noexcept
+  {
+    AssignBytes(type, values.data(), values.size() * sizeof(T));
+  }
+
+  void AssignStrings(nostd::span<const nostd::string_view> strings) noexcept
+  {
+    type_ = kStringArray;
+    size_ = 0;
+    if (strings.empty())
+    {
+      return;
+    }
+
+    // The views are followed by the characters they refer to.
+    auto size = strings.size() * sizeof(nostd::string_view);
+    for (auto &s : strings)
+    {
+      size += s.size();
+    }
+    auto heap_bytes = new (std::nothrow) char[size];
+    if (heap_bytes == nullptr)
+    {
+      return;
+    }
+    auto views      = reinterpret_cast<nostd::string_view *>(heap_bytes);
+    auto characters = heap_bytes + strings.size() * sizeof(nostd::string_view);
+    for (size_t i = 0; i < strings.size(); ++i)
+    {
+      if (!strings[i].empty())
+      {
+        std::memcpy(characters, strings[i].data(), strings[i].size());
+      }
+      new (views + i) nostd::string_view{characters, strings[i].size()};
+      characters += strings[i].size();
+    }
+    SetHeap(heap_bytes, strings.size());
+  }
+
+  void SetHeap(char *bytes, size_t size) noexcept
+  {
+    size_ = kOnHeap;
+    std::memcpy(data_, &bytes, sizeof(bytes));
+    std::memcpy(data_ + sizeof(bytes), &size, sizeof(size));
+  }
+
+  void Assign(const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    switch (value.index())
+    {
+      case kBool:
+        return AssignScalar(kBool, nostd::get<bool>(value));
+      case kInt:
+        return AssignScalar(kInt, nostd::get<int>(value));
+      case kInt64:
+        return AssignScalar(kInt64, nostd::get<int64_t>(value));
+      case kUInt:
+        return AssignScalar(kUInt, nostd::get<unsigned int>(value));
+      case kUInt64:
+        return AssignScalar(kUInt64, nostd::get<uint64_t>(value));
+      case kDouble:
+        return AssignScalar(kDouble, nostd::get<double>(value));
+      case kString: {
+        auto s = nostd::get<nostd::string_view>(value);
+        return AssignBytes(kString, s.data(), s.size());
+      }
+      case kBoolArray:
+        return AssignArray(kBoolArray, nostd::get<nostd::span<const bool>>(value));
+      case kIntArray:
+        return AssignArray(kIntArray, nostd::get<nostd::span<const int>>(value));
+      case kInt64Array:
+        return AssignArray(kInt64Array, nostd::get<nostd::span<const int64_t>>(value));
+      case kUIntArray:
+        return AssignArray(kUIntArray, nostd::get<nostd::span<const unsigned int>>(value));
+      case kUInt64Array:
+        return AssignArray(kUInt64Array, nostd::get<nostd::span<const uint64_t>>(value));
+      case kDoubleArray:
+        return AssignArray(kDoubleArray, nostd::get<nostd::span<const double>>(value));
+      default:
+        return AssignStrings(nostd::get<nostd::span<const nostd::string_view>>(value));
+    }
+  }
+
+  void Take(OwnedAttributeValue &other) noexcept
+  {
+    std::memcpy(data_, other.data_, sizeof(data_));
+    type_       = other.type_;
+    size_       = other.size_;
+    other.size_ = 0;
+  }
+
+  void Free() noexcept
+  {
+    if (size_ == kOnHeap)
+    {
+      delete[] GetBytes();
+    }
+    size_ = 0;
+  }
+};
+
+static_assert(sizeof(OwnedAttributeValue) <= sizeof(opentelemetry::common::AttributeValue),
+              "OwnedAttributeValue must be no larger than AttributeValue");
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * @return a number assigned to the calling thread, counting threads in the
+ * order they first call this function. Since numbers are handed out
+ * sequentially, taking them modulo n spreads threads evenly over n per-thread
+ * slots, e.g. to shard counters.
+ */
+inline size_t GetThreadNumber() noexcept
+{
+  static std::atomic<size_t> num_threads{0};
+  static thread_local size_t thread_number = num_threads.fetch_add(1, std::memory_order_relaxed);
+  return thread_number;
+}
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+#include "opentelemetry/core/timestamp.h"
+#include "opentelemetry/nostd/function_ref.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/common/arena.h"
+#include "opentelemetry/sdk/trace/recordable.h"
+#include "opentelemetry/trace/canonical_code.h"
+#include "opentelemetry/trace/span_id.h"
+#include "opentelemetry/trace/trace_id.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * ArenaSpanData is a representation of all data collected by a span that keeps
+ * the span's name, status description and attributes in an arena.
+ *
+ * Strings and attribute nodes are bump-allocated from a block stored inline in
+ * the object, so a typical span takes a single allocation, and all of its data
+ * is freed at once when the recordable is destroyed. Spans carrying more data
+ * than fits in the inline block spill into heap blocks of growing size.
+ *
+ * Unlike SpanData, string and array attribute values are copied, so they stay
+ * valid after SetAttribute returns. Overwriting an attribute doesn't reclaim
+ * the memory of its previous value.
+ */
+class ArenaSpanData final : public Recordable
+{
+public:
+  /**
+   * The size of the block stored inline in every ArenaSpanData.
+   */
+  static const size_t kInlineArenaSize = 1024;
+
+  ArenaSpanData() noexcept : arena_{inline_arena_, kInlineArenaSize} {}
+
+  /**
+   * Get the trace id for this span
+   * @return the trace id for this span
+   */
+  opentelemetry::trace::TraceId GetTraceId() const noexcept { return trace_id_; }
+
+  /**
+   * Get the span id for this span
+   * @return the span id for this span
+   */
+  opentelemetry::trace::SpanId GetSpanId() const noexcept { return span_id_; }
+
+  /**
+   * Get the parent span id for this span
+   * @return the span id for this span's parent
+   */
+  opentelemetry::trace::SpanId GetParentSpanId() const noexcept { return parent_span_id_; }
+
+  /**
+   * Get the name for this span
+   * @return the name for this span
+   */
+  opentelemetry::nostd::string_view GetName() const noexcept { return name_; }
+
+  /**
+   * Get the status for this span
+   * @return the status for this span
+   */
+  opentelemetry::trace::CanonicalCode GetStatus() const noexcept { return status_code_; }
+
+  /**
+   * Get the status description for this span
+   * @return the description of the the status of this span
+   */
+  opentelemetry::nostd::string_view GetDescription() const noexcept { return status_desc_; }
+
+  /**
+   * Get the start time for this span
+   * @return the start time for this span
+   */
+  opentelemetry::core::SystemTimestamp GetStartTime() const noexcept { return start_time_; }
+
+  /**
+   * Get the duration for this span
+   * @return the duration for this span
+   */
+  std::chrono::nanoseconds GetDuration() const noexcept { return duration_; }
+
+  /**
+   * Get the instrumentation library that produced this span
+   * @return the instrumentation library for this span, or nullptr if it
+   * wasn't set
+   */
+  const InstrumentationLibrary *GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_;
+  }
+
+  /**
+   * Iterate over the attributes of this span in the order they were first set
+   * @param callback a callback to invoke for each attribute. If the callback
+   * returns false, the iteration is aborted.
+   * @return true if every attribute was iterated over
+   */
+  bool ForEachAttribute(
+      nostd::function_ref<bool(nostd::string_view, const opentelemetry::common::AttributeValue &)>
+          callback) const noexcept;
+
+  /**
+   * Get the number of attributes of this span
+   * @return the number of attributes of this span
+   */
+  size_t GetAttributeCount() const noexcept { return num_attributes_; }
+
+  /**
+   * Get the arena holding the data of this span
+   * @return the arena holding the data of this span
+   */
+  const common::Arena &GetArena() const noexcept { return arena_; }
+
+  void SetIds(opentelemetry::trace::TraceId trace_id,
+              opentelemetry::trace::SpanId span_id,
+              opentelemetry::trace::SpanId parent_span_id) noexcept override
+  {
+    trace_id_       = trace_id;
+    span_id_        = span_id;
+    parent_span_id_ = parent_span_id;
+  }
+
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &&value) noexcept override;
+
+  void AddEvent(nostd::string_view name, core::SystemTimestamp timestamp) noexcept override
+  {
+    (void)name;
+    (void)timestamp;
+  }
+
+  void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
+  {
+    status_code_ = code;
+    status_desc_ = arena_.CopyString(description);
+  }
+
+  void SetName(nostd::string_view name) noexcept override { name_ = arena_.CopyString(name); }
+
+  void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
+  {
+    start_time_ = start_time;
+  }
+
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override { duration_ = duration; }
+
+  void SetInstrumentationLibrary(
+      const InstrumentationLibrary &instrumentation_library) noexcept override
+  {
+    instrumentation_library_ = &instrumentation_library;
+  }
+
+  /**
+   * Clear all data collected for the span, so that this object can be reused
+   * for another span.
+   */
+  void Reset() noexcept;
+
+private:
+  struct Attribute
+  {
+    nostd::string_view key;
+    opentelemetry::common::AttributeValue value;
+    Attribute *next;
+  };
+
+  alignas(std::max_align_t) char inline_arena_[kInlineArenaSize];
+  common::Arena arena_;
+  opentelemetry::trace::TraceId trace_id_;
+  opentelemetry::trace::SpanId span_id_;
+  opentelemetry::trace::SpanId parent_span_id_;
+  core::SystemTimestamp start_time_;
+  std::chrono::nanoseconds duration_{0};
+  const InstrumentationLibrary *instrumentation_library_{nullptr};
+  nostd::string_view name_;
+  opentelemetry::trace::CanonicalCode status_code_{opentelemetry::trace::CanonicalCode::OK};
+  nostd::string_view status_desc_;
+  Attribute *first_attribute_{nullptr};
+  Attribute *last_attribute_{nullptr};
+  size_t num_attributes_{0};
+
+  opentelemetry::common::AttributeValue CopyAttributeValue(
+      const opentelemetry::common::AttributeValue &value) noexcept;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * Identifies an attribute key interned in an AttributeKeyTable.
+ */
+using AttributeKeyId = uint32_t;
+
+/**
+ * An append-only table that maps attribute keys to small integer ids.
+ *
+ * Attribute keys repeat on every span, so recordables can store an id instead
+ * of a copy of the key, and exporters can cache per-id data such as the
+ * encoded key. Ids are assigned in order starting at 0 and stay valid for the
+ * lifetime of the table.
+ *
+ * Looking up a key that is already interned, and mapping an id back to its
+ * key, take no lock. Only interning a new key does.
+ *
+ * Keys are never removed, so attribute keys must not be generated from
+ * unbounded data. Once kMaxKeys keys are interned, new keys are rejected.
+ *
+ * This class is thread-safe.
+ */
+class AttributeKeyTable
+{
+public:
+  /**
+   * The id returned for keys that couldn't be interned.
+   */
+  static const AttributeKeyId kInvalidKeyId = 0xffffffff;
+
+  /**
+   * The maximum number of keys in a table.
+   */
+  static const size_t kMaxKeys = 1 << 22;
+
+  AttributeKeyTable() noexcept;
+
+  ~AttributeKeyTable();
+
+  /**
+   * @return the table shared by all recordables in the process
+   */
+  static AttributeKeyTable &GetGlobal() noexcept;
+
+  /**
+   * Get the id of a key, adding the key to the table if necessary.
+   * @param key the key to intern
+   * @return the id of the key, or kInvalidKeyId if the table is full or memory
+   * couldn't be allocated
+   */
+  AttributeKeyId Intern(nostd::string_view key) noexcept;
+
+  /**
+   * Get the id of a key without adding it to the table.
+   * @param key the key to look up
+   * @return the id of the key, or kInvalidKeyId if it isn't interned
+   */
+  AttributeKeyId Find(nostd::string_view key) const noexcept;
+
+  /**
+   * Get the key of an id.
+   * @param id a valid id returned by Intern
+   * @return the interned key. It stays valid for the lifetime of the table.
+   */
+  nostd::string_view GetKey(AttributeKeyId id) const noexcept
+  {
+    auto &entry = chunks_[id >> kChunkBits].load(std::memory_order_acquire)[id & kChunkMask];
+    return nostd::string_view{entry.data.get(), entry.size};
+  }
+
+  /**
+   * @return the number of interned keys
+   */
+  size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+private:
+  static const size_t kChunkBits = 10;
+  static const size_t kChunkSize = 1 << kChunkBits;
+  static const size_t kChunkMask = kChunkSize - 1;
+  static const size_t kMaxChunks = kMaxKeys / kChunkSize;
+
+  // Indexes start at 64 slots and double in size until they can hold kMaxKeys
+  // keys while at most half full.
+  static const size_t kInitialIndexSize = 64;
+  static const size_t kMaxIndexes       = 18;
+  static_assert(kInitialIndexSize << (kMaxIndexes - 1) == 2 * kMaxKeys,
+                "the last index must hold kMaxKeys keys while at most half full");
+
+  struct Key
+  {
+    std::unique_ptr<char[]> data;
+    size_t size;
+    size_t hash;
+  };
+
+  struct Index;
+
+  // Keys are stored in chunks that never move, so ids can be mapped to keys
+  // while new keys are added.
+  std::atomic<Key *> chunks_[kMaxChunks];
+  std::atomic<size_t> size_{0};
+
+  // Maps the hashes of keys to their ids. It's created with the first key.
+  // When an index fills up, it's replaced by a larger one; the old one is kept
+  // alive for readers that may still probe it.
+  std::atomic<Index *> index_{nullptr};
+  std::unique_ptr<Index> indexes_[kMaxIndexes];
+  size_t num_indexes_{0};
+
+  std::mutex mutex_;
+
+  AttributeKeyId FindInIndex(const Index *index, nostd::string_view key, size_t hash) const
+      noexcept;
+
+  bool AddToIndex(AttributeKeyId id) noexcept;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "opentelemetry/sdk/trace/exporter.h"
+#include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+template <class T>
+class ShardedCircularBuffer;
+
+class ThresholdWaiter;
+}  // namespace common
+
+namespace trace
+{
+/**
+ * BackpressurePolicy determines what a BatchSpanProcessor does with a span that
+ * is ended while its queue is full.
+ */
+enum class BackpressurePolicy
+{
+  /**
+   * Drop the span that was just ended.
+   */
+  kDropNewest,
+  /**
+   * Keep the span that was just ended and discard the oldest buffered span
+   * instead. The thread ending the span never blocks. With several queue
+   * shards, the span is discarded from the shard of the thread ending the new
+   * one, since ordering between spans is only kept within a shard.
+   */
+  kDropOldest,
+  /**
+   * Block the thread ending the span until there is room in the queue, for at
+   * most max_block_time. The span is dropped if the queue is still full then.
+   */
+  kBlock
+};
+
+/**
+ * BatchSpanProcessorOptions configures the buffering and export schedule of a
+ * BatchSpanProcessor.
+ */
+struct BatchSpanProcessorOptions
+{
+  // The maximum number of ended spans that are buffered. Spans ended while the
+  // queue is full are dropped.
+  size_t max_queue_size = 2048;
+
+  // The maximum delay between two consecutive exports.
+  std::chrono::milliseconds schedule_delay_millis = std::chrono::milliseconds(5000);
+
+  // The maximum number of spans passed to a single call of SpanExporter::Export.
+  // Reaching this many buffered spans also triggers an export before the
+  // schedule delay has passed.
+  size_t max_export_batch_size = 512;
+
+  // The number of shards the queue is split into. Each thread ending spans is
+  // assigned to one shard, which removes contention between producers on
+  // machines with many cores. The queue capacity is divided evenly between the
+  // shards. A value of 1 uses a single shared queue.
+  size_t num_queue_shards = 1;
+
+  // What to do with spans ended while the queue is full.
+  BackpressurePolicy backpressure_policy = BackpressurePolicy::kDropNewest;
+
+  // The maximum time OnEnd waits for room in the queue when using
+  // BackpressurePolicy::kBlock.
+  std::chrono::microseconds max_block_time = std::chrono::milliseconds(10);
+};
+
+/**
+ * The number of spans a BatchSpanProcessor dropped, by reason.
+ */
+struct BatchSpanProcessorDropCounts
+{
+  // Spans dropped when they were ended because the queue was full
+  // (BackpressurePolicy::kDropNewest).
+  uint64_t dropped_newest = 0;
+
+  // Buffered spans discarded to make room for newer ones
+  // (BackpressurePolicy::kDropOldest).
+  uint64_t dropped_oldest = 0;
+
+  // Spans dropped when they were ended because other threads kept refilling
+  // the queue shard while max_export_batch_size older spans were discarded to
+  // make room for them (BackpressurePolicy::kDropOldest).
+  uint64_t dropped_overflow = 0;
+
+  // Spans dropped after OnEnd blocked for max_block_time without room becoming
+  // available (BackpressurePolicy::kBlock).
+  uint64_t dropped_after_block = 0;
+
+  // Spans ended after the processor was shut down, regardless of the policy.
+  uint64_t dropped_after_shutdown = 0;
+};
+
+/**
+ * The batch span processor buffers ended recordables in a lock-free queue and
+ * passes them in batches to the configured SpanExporter from a dedicated
+ * worker thread, so that exporting never happens on the thread ending a span.
+ *
+ * When exporting is CPU-bound, e.g. on serialization, the processor can be
+ * given several exporters. Each of them gets a worker thread of its own. One
+ * idle worker at a time waits for spans to be queued, and hands this duty over
+ * to the next idle worker before it exports, so the workers drain the queue in
+ * parallel when spans are ended faster than one exporter can keep up with.
+ */
+class BatchSpanProcessor : public SpanProcessor
+{
+public:
+  /**
+   * Initialize a batch span processor and start its worker thread.
+   * @param exporter the exporter used by the span processor. This must not be a
+   * nullptr.
+   * @param options the queue and schedule configuration
+   */
+  explicit BatchSpanProcessor(std::unique_ptr<SpanExporter> &&exporter,
+                              const BatchSpanProcessorOptions &options = {});
+
+  /**
+   * Initialize a batch span processor with one worker thread per exporter.
+   * Every exporter is only ever called from its own worker thread.
+   * @param exporters the exporters used by the span processor. There must be at
+   * least one, and none of them may be a nullptr. Recordables are made by the
+   * first exporter, so all of them must accept its recordables.
+   * @param options the queue and schedule configuration
+   */
+  explicit BatchSpanProcessor(std::vector<std::unique_ptr<SpanExporter>> &&exporters,
+                              const BatchSpanProcessorOptions &options = {});
+
+  ~BatchSpanProcessor() override;
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override;
+
+  void OnStart(Recordable &span) noexcept override;
+
+  /**
+   * Enqueue an ended span for export. If the queue is full, the configured
+   * BackpressurePolicy is applied; only BackpressurePolicy::kBlock ever blocks.
+   */
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override;
+
+  /**
+   * Export all buffered spans and wait for the export to complete.
+   * @param timeout an optional timeout, the default timeout of 0 means that no
+   * timeout is applied.
+   */
+  void ForceFlush(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * Stop the worker threads after exporting all buffered spans, then shut down
+   * the exporters.
+   * @param timeout an optional timeout passed to SpanExporter::Shutdown.
+   */
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the number of spans dropped so far, by reason. This is cheap
+   * enough to be polled for monitoring.
+   */
+  BatchSpanProcessorDropCounts GetDropCounts() const noexcept;
+
+  /**
+   * @return the total number of spans dropped so far.
+   */
+  uint64_t GetDroppedSpanCount() const noexcept;
+
+private:
+  /**
+   * The main loop of a worker thread.
+   * @param worker_index the index of the worker's exporter
+   */
+  void DoBackgroundWork(size_t worker_index) noexcept;
+
+  /**
+   * Wait until no other worker is exporting anymore.
+   */
+  void WaitForBusyWorkers() noexcept;
+
+  /**
+   * Wait for room in the queue and enqueue the span, as long as the queue
+   * doesn't stay full for max_block_time.
+   * @return true if the span was enqueued
+   */
+  bool AddBlocking(std::unique_ptr<Recordable> &span) noexcept;
+
+  /**
+   * @return the number of spans waiting to be exported.
+   */
+  size_t GetQueueSize() const noexcept;
+
+  /**
+   * Export a single batch of spans from the queue.
+   * @param worker_index the index of the calling worker
+   * @param max_spans the maximum number of spans to export
+   * @return the number of spans exported
+   */
+  size_t ExportBatch(size_t worker_index, size_t max_spans) noexcept;
+
+  /**
+   * Export batches until the queue is empty.
+   * @param worker_index the index of the calling worker
+   */
+  void DrainQueue(size_t worker_index) noexcept;
+
+  std::vector<std::unique_ptr<SpanExporter>> exporters_;
+  BatchSpanProcessorOptions options_;
+  std::unique_ptr<common::ShardedCircularBuffer<Recordable>> buffer_;
+
+  // The batch being exported by each worker; only accessed by that worker.
+  std::vector<std::vector<std::unique_ptr<Recordable>>> batches_;
+
+  // Wakes the worker up once a full batch is queued, or for a flush or
+  // shutdown.
+  std::unique_ptr<common::ThresholdWaiter> waiter_;
+
+  std::mutex flush_m_;
+  std::condition_variable flush_cv_;
+  uint64_t flush_requested_count_{0};
+  uint64_t flush_completed_count_{0};
+  std::atomic<bool> is_force_flush_{false};
+
+  std::atomic<bool> is_shutdown_{false};
+
+  // Used by producers blocking for room in the queue.
+  std::mutex space_m_;
+  std::condition_variable space_cv_;
+  std::atomic<size_t> num_blocked_producers_{0};
+
+  std::atomic<uint64_t> dropped_newest_count_{0};
+  std::atomic<uint64_t> dropped_oldest_count_{0};
+  std::atomic<uint64_t> dropped_overflow_count_{0};
+  std::atomic<uint64_t> dropped_after_block_count_{0};
+  std::atomic<uint64_t> dropped_after_shutdown_count_{0};
+
+  // Held by the worker that waits for spans to be queued.
+  std::mutex leader_m_;
+
+  // Counts the workers exporting without holding leader_m_.
+  std::mutex busy_m_;
+  std::condition_variable busy_cv_;
+  size_t num_busy_workers_{0};
+
+  std::vector<std::thread> worker_threads_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
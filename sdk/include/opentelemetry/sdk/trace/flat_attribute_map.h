@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/common/owned_attribute_value.h"
+#include "opentelemetry/sdk/trace/attribute_key_table.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * A map from attribute keys to values that stores its entries contiguously.
+ *
+ * Keys are interned in the global AttributeKeyTable, and entries store the
+ * ids of their keys, so that keys aren't copied for every span and are
+ * compared as integers.
+ *
+ * The first kInlineCapacity entries are stored inline in the map; more spill
+ * into a heap array that grows geometrically. Small maps are searched
+ * linearly. Once a map spills, it also keeps an open-addressing index of its
+ * entries, so that spans with many attributes don't take quadratic time to
+ * build.
+ *
+ * Entries are iterated in the order their keys were first set. Setting an
+ * existing key overwrites its value. Values are copied into
+ * OwnedAttributeValues, so they don't refer to the caller's memory.
+ *
+ * This class is thread-compatible.
+ */
+class FlatAttributeMap
+{
+public:
+  struct Entry
+  {
+    AttributeKeyId key_id;
+    sdk::common::OwnedAttributeValue value;
+
+    nostd::string_view GetKey() const noexcept
+    {
+      return AttributeKeyTable::GetGlobal().GetKey(key_id);
+    }
+  };
+
+  using const_iterator = const Entry *;
+
+  /**
+   * The number of entries stored without a heap allocation.
+   */
+  static const size_t kInlineCapacity = 8;
+
+  FlatAttributeMap() noexcept = default;
+
+  FlatAttributeMap(const FlatAttributeMap &) = delete;
+  FlatAttributeMap &operator=(const FlatAttributeMap &) = delete;
+
+  ~FlatAttributeMap()
+  {
+    clear();
+    if (!IsInline())
+    {
+      ::operator delete(entries_);
+    }
+    delete[] index_;
+  }
+
+  /**
+   * Set the value of an attribute, replacing any previous value of the key.
+   * @param key the key of the attribute
+   * @param value the value of the attribute
+   *
+   * Note: The attribute is dropped if memory for it can't be allocated.
+   */
+  void Set(nostd::string_view key, const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    auto key_id = AttributeKeyTable::GetGlobal().Intern(key);
+    if (key_id != AttributeKeyTable::kInvalidKeyId)
+    {
+      Set(key_id, value);
+    }
+  }
+
+  /**
+   * Set the value of an attribute, replacing any previous value of the key.
+   * @param key_id the id of the attribute's key in the global AttributeKeyTable
+   * @param value the value of the attribute
+   */
+  void Set(AttributeKeyId key_id, const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    auto entry = FindEntry(key_id);
+    if (entry != nullptr)
+    {
+      entry->value = value;
+      return;
+    }
+    if (size_ == capacity_ && !Grow())
+    {
+      return;
+    }
+    new (entries_ + size_) Entry{key_id, value};
+    if (index_ != nullptr)
+    {
+      AddToIndex(size_);
+    }
+    ++size_;
+  }
+
+  /**
+   * Find the value of an attribute.
+   * @param key the key of the attribute
+   * @return the value of the attribute, or nullptr if it isn't set
+   */
+  const sdk::common::OwnedAttributeValue *Find(nostd::string_view key) const noexcept
+  {
+    return Find(AttributeKeyTable::GetGlobal().Find(key));
+  }
+
+  /**
+   * Find the value of an attribute.
+   * @param key_id the id of the attribute's key in the global AttributeKeyTable
+   * @return the value of the attribute, or nullptr if it isn't set
+   */
+  const sdk::common::OwnedAttributeValue *Find(AttributeKeyId key_id) const noexcept
+  {
+    auto entry = FindEntry(key_id);
+    return entry == nullptr ? nullptr : &entry->value;
+  }
+
+  /**
+   * Remove all entries. Heap memory is kept for reuse.
+   */
+  void clear() noexcept
+  {
+    for (size_t i = 0; i < size_; ++i)
+    {
+      entries_[i].~Entry();
+    }
+    size_ = 0;
+    if (index_ != nullptr)
+    {
+      for (size_t i = 0; i <= index_mask_; ++i)
+      {
+        index_[i] = kEmptySlot;
+      }
+    }
+  }
+
+  size_t size() const noexcept { return size_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  const_iterator begin() const noexcept { return entries_; }
+
+  const_iterator end() const noexcept { return entries_ + size_; }
+
+private:
+  static const uint32_t kEmptySlot = 0xffffffff;
+
+  Entry *entries_ = reinterpret_cast<Entry *>(inline_entries_);
+  size_t size_{0};
+  size_t capacity_{kInlineCapacity};
+
+  // Positions of the entries by the hash of their keys, or nullptr while the
+  // entries are stored inline.
+  uint32_t *index_{nullptr};
+  size_t index_mask_{0};
+
+  alignas(Entry) char inline_entries_[kInlineCapacity * sizeof(Entry)];
+
+  bool IsInline() const noexcept
+  {
+    return entries_ == reinterpret_cast<const Entry *>(inline_entries_);
+  }
+
+  static size_t Hash(AttributeKeyId key_id) noexcept
+  {
+    // Fibonacci hashing spreads consecutive ids over the index.
+    return static_cast<size_t>((key_id * 0x9e3779b97f4a7c15ull) >> 32);
+  }
+
+  Entry *FindEntry(AttributeKeyId key_id) const noexcept
+  {
+    if (index_ == nullptr)
+    {
+      for (size_t i = 0; i < size_; ++i)
+      {
+        if (entries_[i].key_id == key_id)
+        {
+          return entries_ + i;
+        }
+      }
+      return nullptr;
+    }
+    auto slot = Hash(key_id) & index_mask_;
+    while (index_[slot] != kEmptySlot)
+    {
+      auto entry = entries_ + index_[slot];
+      if (entry->key_id == key_id)
+      {
+        return entry;
+      }
+      slot = (slot + 1) & index_mask_;
+    }
+    return nullptr;
+  }
+
+  void AddToIndex(size_t position) noexcept
+  {
+    auto slot = Hash(entries_[position].key_id) & index_mask_;
+    while (index_[slot] != kEmptySlot)
+    {
+      slot = (slot + 1) & index_mask_;
+    }
+    index_[slot] = static_cast<uint32_t>(position);
+  }
+
+  bool Grow() noexcept
+  {
+    auto capacity = 2 * capacity_;
+    auto entries  = static_cast<Entry *>(::operator new(capacity * sizeof(Entry), std::nothrow));
+    // The index is kept at most half full.
+    auto index = new (std::nothrow) uint32_t[2 * capacity];
+    if (entries == nullptr || index == nullptr)
+    {
+      ::operator delete(entries);
+      delete[] index;
+      return false;
+    }
+    for (size_t i = 0; i < size_; ++i)
+    {
+      new (entries + i) Entry{std::move(entries_[i])};
+      entries_[i].~Entry();
+    }
+    if (!IsInline())
+    {
+      ::operator delete(entries_);
+    }
+    delete[] index_;
+    entries_    = entries;
+    capacity_   = capacity;
+    index_      = index;
+    index_mask_ = 2 * capacity - 1;
+    for (size_t i = 0; i <= index_mask_; ++i)
+    {
+      index_[i] = kEmptySlot;
+    }
+    for (size_t i = 0; i < size_; ++i)
+    {
+      AddToIndex(i);
+    }
+    return true;
+  }
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "opentelemetry/trace/span_id.h"
+#include "opentelemetry/trace/trace_id.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace trace_api = opentelemetry::trace;
+
+/**
+ * An IdGenerator creates the trace and span ids of new spans. It's called
+ * for every span, from any thread, so implementations must be thread-safe.
+ */
+class IdGenerator
+{
+public:
+  virtual ~IdGenerator() = default;
+
+  /**
+   * @return a new, valid trace id.
+   */
+  virtual trace_api::TraceId GenerateTraceId() noexcept = 0;
+
+  /**
+   * @return a new, valid span id.
+   */
+  virtual trace_api::SpanId GenerateSpanId() noexcept = 0;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * Identifies the library that produced a span, by the name and version passed
+ * to TracerProvider::GetTracer.
+ *
+ * Instances are interned: there is exactly one for every name and version,
+ * and it's never destroyed. Recordables can therefore refer to the library of
+ * a span with a plain pointer, instead of copying its name and version, and
+ * exporters can compare libraries by address.
+ *
+ * This class is thread-safe.
+ */
+class InstrumentationLibrary
+{
+public:
+  /**
+   * Get the library with a name and version, creating it if necessary.
+   * @param name the name of the library
+   * @param version the version of the library
+   * @return the library. It stays valid for the lifetime of the process.
+   *
+   * Note: Libraries are never freed, so names and versions must not be
+   * generated from unbounded data.
+   *
+   * Note: Unlike most of the SDK, this method lets std::bad_alloc propagate,
+   * since there's no library to return if a new one can't be allocated.
+   */
+  static const InstrumentationLibrary &Get(nostd::string_view name,
+                                           nostd::string_view version = "");
+
+  InstrumentationLibrary(const InstrumentationLibrary &) = delete;
+  InstrumentationLibrary &operator=(const InstrumentationLibrary &) = delete;
+
+  /**
+   * @return the name of the library
+   */
+  nostd::string_view GetName() const noexcept { return name_; }
+
+  /**
+   * @return the version of the library
+   */
+  nostd::string_view GetVersion() const noexcept { return version_; }
+
+private:
+  std::string name_;
+  std::string version_;
+
+  InstrumentationLibrary(nostd::string_view name, nostd::string_view version)
+      : name_{name.data(), name.size()}, version_{version.data(), version.size()}
+  {}
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
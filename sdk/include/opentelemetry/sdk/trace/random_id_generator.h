@@ -0,0 +1,30 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/id_generator.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The RandomIdGenerator creates random ids, which is the default.
+ *
+ * Each thread draws ids from its own pool of random numbers, which is
+ * refilled in bulk once it runs out, so generating an id takes no
+ * synchronization. After a fork, the pool of the forking thread is discarded
+ * in the child, so that parent and child don't hand out the same ids.
+ */
+class RandomIdGenerator final : public IdGenerator
+{
+public:
+  RandomIdGenerator() noexcept;
+
+  trace_api::TraceId GenerateTraceId() noexcept override;
+
+  trace_api::SpanId GenerateSpanId() noexcept override;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
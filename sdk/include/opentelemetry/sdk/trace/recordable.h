@@ -3,6 +3,7 @@
 #include "opentelemetry/common/attribute_value.h"
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
 #include "opentelemetry/trace/canonical_code.h"
 #include "opentelemetry/trace/span_id.h"
 #include "opentelemetry/trace/trace_id.h"
@@ -74,6 +75,20 @@ class Recordable
    * @param duration the duration to set
    */
   virtual void SetDuration(std::chrono::nanoseconds duration) noexcept = 0;
+
+  /**
+   * Set the instrumentation library that produced the span.
+   * @param instrumentation_library the library of the tracer that started the
+   * span. It's interned, so it outlives the recordable.
+   *
+   * Recordables that don't export the library can ignore it, which is the
+   * default.
+   */
+  virtual void SetInstrumentationLibrary(
+      const InstrumentationLibrary &instrumentation_library) noexcept
+  {
+    (void)instrumentation_library;
+  }
 };
 }  // namespace trace
 }  // namespace sdk
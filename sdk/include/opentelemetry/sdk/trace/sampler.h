@@ -1,11 +1,13 @@
 #pragma once
 
-#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/trace/flat_attribute_map.h"
+#include "opentelemetry/trace/key_value_iterable.h"
 #include "opentelemetry/trace/span.h"
+#include "opentelemetry/trace/span_context.h"
 #include "opentelemetry/trace/trace_id.h"
 #include "opentelemetry/version.h"
 
-#include <map>
 #include <memory>
 #include <string>
 
@@ -31,14 +33,19 @@ enum class Decision
 };
 
 /**
- * The output of ShouldSample. 
+ * The output of ShouldSample.
  * It contains a sampling Decision and a set of Span Attributes.
+ *
+ * Most samplers add no attributes, so the attributes are only allocated when
+ * a sampler has some to add, and a SamplingResult without them is just its
+ * Decision.
  */
 struct SamplingResult
 {
   Decision decision;
-  // A set of span Attributes that will also be added to the Span. Can be nullptr.
-  std::unique_ptr<std::map<std::string, openelemetry::common::AttributeValue>> attributes;
+  // A set of span Attributes that will also be added to the Span. nullptr if
+  // there are none.
+  std::unique_ptr<FlatAttributeMap> attributes;
 };
 
 /**
@@ -48,8 +55,6 @@ struct SamplingResult
 class Sampler
 {
 public:
-  // TODO: Remove this placeholder with real class
-  class SpanContext;
   virtual ~Sampler() = default;
   /**
    * Called during Span creation to make a sampling decision.
@@ -66,11 +71,11 @@ class Sampler
    * @since 0.1.0
    */
 
-  virtual SamplingResult ShouldSample(const SpanContext *parent_context,
+  virtual SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
                                       trace_api::TraceId trace_id,
                                       nostd::string_view name,
                                       trace_api::SpanKind span_kind,
-                                      const KeyValueIterable &attributes) noexcept = 0;
+                                      const trace_api::KeyValueIterable &attributes) noexcept = 0;
 
   /**
    * Returns the sampler name or short description with the configuration.
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * AdaptiveSamplerOptions configures the target and the adjustment schedule of
+ * an AdaptiveSampler.
+ */
+struct AdaptiveSamplerOptions
+{
+  // The number of spans to sample per second.
+  double target_spans_per_second = 100.0;
+
+  // How often the sampling ratio is adjusted. A value of 0 starts no worker
+  // thread; AdjustRatio must then be called instead.
+  std::chrono::milliseconds adjustment_interval = std::chrono::milliseconds(1000);
+
+  // The sampling ratio until the first adjustment.
+  double initial_ratio = 1.0;
+
+  // The weight of the latest interval in the smoothed span rate, in (0, 1].
+  // Lower values react more slowly to short spikes.
+  double smoothing = 0.5;
+};
+
+/**
+ * The AdaptiveSampler samples traces by trace id like the
+ * TraceIdRatioBasedSampler, but adjusts the ratio every interval so that the
+ * number of sampled spans per second approaches a target.
+ *
+ * ShouldSample only reads the current threshold and increments a counter of
+ * the calling thread's slot, so it takes no lock and threads don't contend on
+ * a shared counter. The span rate is measured and the threshold updated on a
+ * worker thread.
+ */
+class AdaptiveSampler final : public Sampler
+{
+public:
+  /**
+   * Initialize an adaptive sampler and start its worker thread.
+   * @param options the target and adjustment configuration
+   */
+  explicit AdaptiveSampler(const AdaptiveSamplerOptions &options = {});
+
+  ~AdaptiveSampler() override;
+
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  std::string GetDescription() const noexcept override { return description_; }
+
+  /**
+   * Measure the span rate since the last adjustment and update the sampling
+   * ratio. This is called by the worker thread, or by the user if
+   * adjustment_interval is 0.
+   * @param elapsed the time since the last adjustment
+   */
+  void AdjustRatio(std::chrono::nanoseconds elapsed) noexcept;
+
+  /**
+   * @return the current sampling ratio.
+   */
+  double GetRatio() const noexcept;
+
+private:
+  static const size_t kNumCounterSlots = 64;
+  static const size_t kCacheLineSize   = 64;
+
+  // Counts the spans ShouldSample was called for by the threads assigned to
+  // the slot. Slots are padded so that they don't share cache lines.
+  struct CounterSlot
+  {
+    std::atomic<uint64_t> count{0};
+    char padding[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+  };
+
+  /**
+   * The main loop of the worker thread.
+   */
+  void DoBackgroundWork() noexcept;
+
+  AdaptiveSamplerOptions options_;
+  std::string description_;
+
+  // The threshold of TraceIdRatioBasedSampler::IsSampled.
+  std::atomic<uint64_t> threshold_;
+  // The ratio threshold_ was computed from.
+  std::atomic<double> ratio_;
+
+  CounterSlot counters_[kNumCounterSlots];
+
+  // The state of the measurement, guarded by adjust_m_.
+  std::mutex adjust_m_;
+  uint64_t last_count_  = 0;
+  double smoothed_rate_ = -1.0;
+
+  std::mutex shutdown_m_;
+  std::condition_variable shutdown_cv_;
+  bool is_shutdown_ = false;
+
+  std::thread worker_thread_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
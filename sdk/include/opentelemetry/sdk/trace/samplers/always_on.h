@@ -0,0 +1,30 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The AlwaysOnSampler records and samples every span.
+ */
+class AlwaysOnSampler final : public Sampler
+{
+public:
+  SamplingResult ShouldSample(const trace_api::SpanContext * /*parent_context*/,
+                              trace_api::TraceId /*trace_id*/,
+                              nostd::string_view /*name*/,
+                              trace_api::SpanKind /*span_kind*/,
+                              const trace_api::KeyValueIterable & /*attributes*/) noexcept override
+  {
+    return {Decision::RECORD_AND_SAMPLE, nullptr};
+  }
+
+  std::string GetDescription() const noexcept override { return "AlwaysOnSampler"; }
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
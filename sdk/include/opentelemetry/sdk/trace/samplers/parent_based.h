@@ -0,0 +1,53 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+#include <memory>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The ParentBasedSampler follows the sampling decision of a span's parent,
+ * and delegates the decision for root spans to another sampler.
+ */
+class ParentBasedSampler final : public Sampler
+{
+public:
+  /**
+   * @param root_sampler the sampler that decides for spans without a valid
+   * parent. This must not be a nullptr.
+   */
+  explicit ParentBasedSampler(std::shared_ptr<Sampler> root_sampler) noexcept
+      : root_sampler_{std::move(root_sampler)}
+  {}
+
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override
+  {
+    if (parent_context == nullptr || !parent_context->IsValid())
+    {
+      return root_sampler_->ShouldSample(parent_context, trace_id, name, span_kind, attributes);
+    }
+    return {parent_context->IsSampled() ? Decision::RECORD_AND_SAMPLE : Decision::NOT_RECORD,
+            nullptr};
+  }
+
+  std::string GetDescription() const noexcept override
+  {
+    return "ParentBased{" + root_sampler_->GetDescription() + "}";
+  }
+
+private:
+  const std::shared_ptr<Sampler> root_sampler_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
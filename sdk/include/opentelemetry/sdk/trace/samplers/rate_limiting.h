@@ -0,0 +1,58 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The RateLimitingSampler samples at most a given number of spans per second.
+ *
+ * It's a token bucket that holds up to one second's worth of spans, so bursts
+ * after a quiet period are sampled up to that size. Instead of a token count,
+ * the bucket keeps a single atomic timestamp: the time at which it will be
+ * full again. Sampling a span moves that time forward by the interval between
+ * two spans, and a span is dropped if that would put it more than a second
+ * ahead. Dropping a span only reads the timestamp, so once the limit is
+ * reached, threads don't contend on it.
+ *
+ * Share one sampler among all tracers, e.g. through the TracerProvider, to
+ * limit the spans of the whole process.
+ */
+class RateLimitingSampler final : public Sampler
+{
+public:
+  /**
+   * @param spans_per_second the maximum number of spans to sample per second.
+   * Rates below 0 are treated as 0.
+   */
+  explicit RateLimitingSampler(double spans_per_second) noexcept;
+
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  std::string GetDescription() const noexcept override { return description_; }
+
+private:
+  // The time it takes to earn the token for one span, in nanoseconds, or 0 if
+  // no spans are sampled.
+  int64_t interval_;
+  // How far ahead of the current time full_time_ may be, in nanoseconds.
+  int64_t max_debt_;
+  // The steady clock time, in nanoseconds, at which the bucket is full.
+  std::atomic<int64_t> full_time_{0};
+  std::string description_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "opentelemetry/sdk/common/owned_attribute_value.h"
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * A SamplingRule selects the sampler that decides about the spans it matches.
+ */
+struct SamplingRule
+{
+  // The span name to match. If is_prefix is set, every name that starts with
+  // it matches, so an empty prefix matches all spans.
+  std::string name;
+  bool is_prefix = false;
+
+  // The span kind to match, if match_span_kind is set.
+  bool match_span_kind          = false;
+  trace_api::SpanKind span_kind = trace_api::SpanKind::kInternal;
+
+  // Attributes that a span must be started with, with equal values.
+  std::vector<std::pair<std::string, sdk::common::OwnedAttributeValue>> attributes;
+
+  // The sampler for matching spans. This must not be a nullptr.
+  std::shared_ptr<Sampler> sampler;
+};
+
+/**
+ * The RuleBasedSampler delegates each span to the sampler of the first rule
+ * that matches it, or to a default sampler.
+ *
+ * The span names of the rules are compiled into a trie when the sampler is
+ * created, so finding the matching rules walks the span name once, whatever
+ * the number of rules, and takes no allocation. Span kinds and attributes
+ * are only compared for rules whose name matches.
+ */
+class RuleBasedSampler final : public Sampler
+{
+public:
+  /**
+   * @param rules the rules, in the order they're tried
+   * @param default_sampler the sampler for spans that no rule matches. This
+   * must not be a nullptr.
+   */
+  RuleBasedSampler(std::vector<SamplingRule> rules, std::shared_ptr<Sampler> default_sampler);
+
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  std::string GetDescription() const noexcept override;
+
+private:
+  // A node of the trie, for the name prefix on the path from the root. Its
+  // edges and rules are ranges of edges_ and rule_indices_.
+  struct Node
+  {
+    uint32_t first_edge;
+    uint32_t num_edges;
+    // The rules whose name prefix ends at this node.
+    uint32_t first_prefix_rule;
+    uint32_t num_prefix_rules;
+    // The rules whose exact name ends at this node.
+    uint32_t first_exact_rule;
+    uint32_t num_exact_rules;
+  };
+
+  // The edges of a node are sorted by character.
+  struct Edge
+  {
+    char character;
+    uint32_t node;
+  };
+
+  /**
+   * Find the first rule in a range of rule_indices_ that matches a span, if
+   * it comes before best_rule.
+   * @return the index of the rule that comes first
+   */
+  uint32_t FindFirstMatch(uint32_t first,
+                          uint32_t count,
+                          uint32_t best_rule,
+                          trace_api::SpanKind span_kind,
+                          const trace_api::KeyValueIterable &attributes) const noexcept;
+
+  std::vector<SamplingRule> rules_;
+  std::shared_ptr<Sampler> default_sampler_;
+
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+  std::vector<uint32_t> rule_indices_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
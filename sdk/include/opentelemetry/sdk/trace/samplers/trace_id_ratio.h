@@ -0,0 +1,60 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/version.h"
+
+#include <cstdint>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The TraceIdRatioBasedSampler samples a given fraction of traces.
+ *
+ * The decision is taken from the last 8 bytes of the trace id, which are
+ * random, so no hashing is needed: a span is sampled if they're below a
+ * threshold derived from the ratio. All spans of a trace get the same
+ * decision, and a sampler with a higher ratio samples a superset of the
+ * traces sampled by one with a lower ratio.
+ */
+class TraceIdRatioBasedSampler final : public Sampler
+{
+public:
+  /**
+   * @param ratio the fraction of traces to sample. Ratios below 0 are treated
+   * as 0, and ratios above 1 as 1.
+   */
+  explicit TraceIdRatioBasedSampler(double ratio) noexcept;
+
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  std::string GetDescription() const noexcept override { return description_; }
+
+  /**
+   * @param ratio the fraction of traces to sample, clamped to [0, 1]
+   * @return the threshold that samples that fraction of traces
+   */
+  static uint64_t RatioToThreshold(double ratio) noexcept;
+
+  /**
+   * @param trace_id the id of the trace
+   * @param threshold a threshold returned by RatioToThreshold
+   * @return whether the trace is sampled at the threshold: if its last 8
+   * bytes are below it, or if the threshold is UINT64_MAX, for a ratio of 1.
+   */
+  static bool IsSampled(const trace_api::TraceId &trace_id, uint64_t threshold) noexcept;
+
+private:
+  uint64_t threshold_;
+  std::string description_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,9 +1,9 @@
 #pragma once
 
 #include <chrono>
-#include <unordered_map>
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/trace/flat_attribute_map.h"
 #include "opentelemetry/sdk/trace/recordable.h"
 #include "opentelemetry/trace/canonical_code.h"
 #include "opentelemetry/trace/span_id.h"
@@ -69,14 +69,21 @@ class SpanData final : public Recordable
   std::chrono::nanoseconds GetDuration() const noexcept { return duration_; }
 
   /**
-   * Get the attributes for this span
-   * @return the attributes for this span
+   * Get the instrumentation library that produced this span
+   * @return the instrumentation library for this span, or nullptr if it
+   * wasn't set
    */
-  const std::unordered_map<std::string, common::AttributeValue> &GetAttributes() const noexcept
+  const InstrumentationLibrary *GetInstrumentationLibrary() const noexcept
   {
-    return attributes_;
+    return instrumentation_library_;
   }
 
+  /**
+   * Get the attributes for this span
+   * @return the attributes for this span
+   */
+  const FlatAttributeMap &GetAttributes() const noexcept { return attributes_; }
+
   void SetIds(opentelemetry::trace::TraceId trace_id,
               opentelemetry::trace::SpanId span_id,
               opentelemetry::trace::SpanId parent_span_id) noexcept override
@@ -86,9 +93,10 @@ class SpanData final : public Recordable
     parent_span_id_ = parent_span_id;
   }
 
-  void SetAttribute(nostd::string_view key, const common::AttributeValue &&value) noexcept override
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &&value) noexcept override
   {
-    attributes_[std::string(key)] = value;
+    attributes_.Set(key, value);
   }
 
   void AddEvent(nostd::string_view name, core::SystemTimestamp timestamp) noexcept override
@@ -100,10 +108,13 @@ class SpanData final : public Recordable
   void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
   {
     status_code_ = code;
-    status_desc_ = std::string(description);
+    status_desc_.assign(description.data(), description.size());
   }
 
-  void SetName(nostd::string_view name) noexcept override { name_ = std::string(name); }
+  void SetName(nostd::string_view name) noexcept override
+  {
+    name_.assign(name.data(), name.size());
+  }
 
   void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
   {
@@ -112,16 +123,41 @@ class SpanData final : public Recordable
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override { duration_ = duration; }
 
+  void SetInstrumentationLibrary(
+      const InstrumentationLibrary &instrumentation_library) noexcept override
+  {
+    instrumentation_library_ = &instrumentation_library;
+  }
+
+  /**
+   * Clear all data collected for the span, so that this object can be reused
+   * for another span. Strings keep their capacity.
+   */
+  void Reset() noexcept
+  {
+    trace_id_                = opentelemetry::trace::TraceId();
+    span_id_                 = opentelemetry::trace::SpanId();
+    parent_span_id_          = opentelemetry::trace::SpanId();
+    start_time_              = core::SystemTimestamp();
+    duration_                = std::chrono::nanoseconds(0);
+    instrumentation_library_ = nullptr;
+    name_.clear();
+    status_code_ = opentelemetry::trace::CanonicalCode::OK;
+    status_desc_.clear();
+    attributes_.clear();
+  }
+
 private:
   opentelemetry::trace::TraceId trace_id_;
   opentelemetry::trace::SpanId span_id_;
   opentelemetry::trace::SpanId parent_span_id_;
   core::SystemTimestamp start_time_;
   std::chrono::nanoseconds duration_{0};
+  const InstrumentationLibrary *instrumentation_library_{nullptr};
   std::string name_;
   opentelemetry::trace::CanonicalCode status_code_{opentelemetry::trace::CanonicalCode::OK};
   std::string status_desc_;
-  std::unordered_map<std::string, common::AttributeValue> attributes_;
+  FlatAttributeMap attributes_;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+
+#include "opentelemetry/sdk/trace/recordable.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+class SpanDataPoolStorage;
+
+/**
+ * SpanDataPool recycles SpanData recordables, so that exporters using SpanData
+ * don't allocate a new recordable for every span.
+ *
+ * An exporter makes its recordables with MakeRecordable and hands them back
+ * with Recycle once they were exported. Every thread keeps a small cache of
+ * idle recordables, and caches are refilled from and returned to a list shared
+ * by all threads a batch at a time. Recordables are typically made on the
+ * threads ending spans and recycled on an export thread, and this way neither
+ * takes a lock for every span.
+ *
+ * This class is thread-safe.
+ */
+class SpanDataPool
+{
+public:
+  /**
+   * @param max_size the maximum number of idle recordables kept in the shared
+   * list. Recordables recycled beyond this are deleted.
+   */
+  explicit SpanDataPool(size_t max_size = 4096);
+
+  ~SpanDataPool();
+
+  /**
+   * @return an empty SpanData recordable, reused from an earlier span if one
+   * is available
+   */
+  std::unique_ptr<Recordable> MakeRecordable() noexcept;
+
+  /**
+   * Give a recordable back to the pool once it was exported.
+   * @param recordable a recordable made by this pool's MakeRecordable.
+   */
+  void Recycle(std::unique_ptr<Recordable> &&recordable) noexcept;
+
+  /**
+   * @return the number of idle recordables in the shared list, not counting
+   * the ones cached by threads.
+   */
+  size_t GetSharedSize() const noexcept;
+
+private:
+  std::shared_ptr<SpanDataPoolStorage> storage_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * TailSamplingProcessorOptions configures which traces a TailSamplingProcessor
+ * keeps, and how many spans it buffers while it waits to decide.
+ */
+struct TailSamplingProcessorOptions
+{
+  // A trace is decided once no span of it has ended for this long, unless its
+  // root span ends first.
+  std::chrono::milliseconds decision_wait = std::chrono::milliseconds(5000);
+
+  // Traces with a span that took at least this long are always kept.
+  std::chrono::nanoseconds latency_threshold = std::chrono::milliseconds(1000);
+
+  // Decides whether to keep the traces that have neither an error nor a slow
+  // span. It's only given the trace id. This must not be a nullptr.
+  std::shared_ptr<Sampler> sampler = std::make_shared<TraceIdRatioBasedSampler>(0.01);
+
+  // The memory budget: the maximum number of ended spans buffered while their
+  // traces are undecided. Once it's reached, the traces whose last span ended
+  // longest ago are decided early with the spans seen so far.
+  size_t max_buffered_spans = 100000;
+
+  // The number of shards the buffered traces are split into, by trace id.
+  // Each shard has a lock of its own, so threads ending spans of different
+  // traces rarely contend. The span budget is divided evenly between shards.
+  size_t num_shards = 16;
+};
+
+/**
+ * The tail sampling processor decides which spans to keep per trace, after
+ * their spans have ended, and passes the spans of kept traces to another
+ * processor.
+ *
+ * Every trace that contains a span with an error status, or a span that took
+ * at least latency_threshold, is kept. The configured sampler decides about
+ * the rest. Ended spans are buffered by trace id until the root span of their
+ * trace ends, or until no span of the trace has ended for decision_wait.
+ * Spans of a trace that end after it was decided are buffered and decided as
+ * a new trace.
+ *
+ * Recordables are wrapped so that the processor can read the trace id, status
+ * and duration of a span, so they must be made by this processor.
+ */
+class TailSamplingProcessor : public SpanProcessor
+{
+public:
+  /**
+   * Initialize a tail sampling processor and start its worker thread.
+   * @param processor the processor that the spans of kept traces are passed
+   * to. It makes the wrapped recordables. This must not be a nullptr.
+   * @param options the sampling and buffering configuration
+   */
+  explicit TailSamplingProcessor(std::unique_ptr<SpanProcessor> &&processor,
+                                 const TailSamplingProcessorOptions &options = {});
+
+  ~TailSamplingProcessor() override;
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override;
+
+  void OnStart(Recordable &span) noexcept override;
+
+  /**
+   * Buffer an ended span with the other spans of its trace. If it's the root
+   * span, or the buffer is over budget, traces are decided on the calling
+   * thread.
+   */
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override;
+
+  /**
+   * Decide all buffered traces, then flush the next processor.
+   * @param timeout an optional timeout passed to the next processor.
+   */
+  void ForceFlush(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * Stop the worker thread, decide all buffered traces, then shut down the next
+   * processor.
+   * @param timeout an optional timeout passed to the next processor.
+   */
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the number of spans buffered in undecided traces.
+   */
+  size_t GetBufferedSpanCount() const noexcept;
+
+  /**
+   * @return the number of traces decided early because the buffer was over
+   * budget.
+   */
+  uint64_t GetEvictedTraceCount() const noexcept;
+
+private:
+  struct Trace;
+  struct Shard;
+
+  /**
+   * The main loop of the worker thread, which decides quiet traces.
+   */
+  void DoBackgroundWork() noexcept;
+
+  /**
+   * Decide the buffered traces that no span has ended for since cutoff.
+   */
+  void DecideTracesBefore(std::chrono::steady_clock::time_point cutoff) noexcept;
+
+  /**
+   * Pass the spans of a trace on to the next processor if the trace is kept,
+   * or drop them.
+   */
+  void Decide(Trace &trace) noexcept;
+
+  std::unique_ptr<SpanProcessor> processor_;
+  TailSamplingProcessorOptions options_;
+  size_t max_spans_per_shard_;
+  std::unique_ptr<Shard[]> shards_;
+
+  std::atomic<uint64_t> evicted_trace_count_{0};
+
+  std::mutex shutdown_m_;
+  std::condition_variable shutdown_cv_;
+  std::atomic<bool> is_shutdown_{false};
+
+  std::thread worker_thread_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
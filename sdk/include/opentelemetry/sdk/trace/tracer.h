@@ -1,10 +1,17 @@
 #pragma once
 
 #include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/sdk/trace/id_generator.h"
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
 #include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/sdk/trace/random_id_generator.h"
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/trace/tracer.h"
 #include "opentelemetry/version.h"
 
+#include <chrono>
+#include <functional>
 #include <memory>
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -12,6 +19,36 @@ namespace sdk
 {
 namespace trace
 {
+/**
+ * SpanSynchronization determines how spans guard their data against
+ * concurrent access.
+ */
+enum class SpanSynchronization
+{
+  /**
+   * Spans can be used from several threads at once.
+   */
+  kThreadSafe,
+  /**
+   * Each span must only be used by one thread at a time, e.g. because it
+   * never leaves the request it was started for. Spans skip locking entirely.
+   */
+  kSingleOwner
+};
+
+/**
+ * Decides when a deferred span ends whether it's recorded after all.
+ *
+ * Spans that the sampler doesn't record are deferred if a tracer has a
+ * predicate: they keep their ids, name, timestamps, status and a few
+ * attributes inline until they end, and are only passed to the processor if
+ * the predicate returns true.
+ * @param duration how long the span took
+ * @param status the status the span ended with
+ */
+using DeferredSamplingPredicate =
+    std::function<bool(std::chrono::nanoseconds duration, trace_api::CanonicalCode status)>;
+
 class Tracer final : public trace_api::Tracer, public std::enable_shared_from_this<Tracer>
 {
 public:
@@ -19,8 +56,31 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    * Initialize a new tracer.
    * @param processor The span processor for this tracer. This must not be a
    * nullptr.
+   * @param span_synchronization How the spans started by this tracer guard
+   * their data against concurrent access.
+   * @param instrumentation_library The library whose spans this tracer starts.
+   * @param sampler The sampler that decides which spans are recorded. This
+   * must not be a nullptr.
+   * @param deferred_sampling_predicate Decides which spans that the sampler
+   * didn't record are recorded when they end. If empty, they never are.
+   * @param id_generator Creates the trace and span ids of new spans. This
+   * must not be a nullptr.
    */
-  explicit Tracer(std::shared_ptr<SpanProcessor> processor) noexcept : processor_{processor} {}
+  explicit Tracer(std::shared_ptr<SpanProcessor> processor,
+                  SpanSynchronization span_synchronization = SpanSynchronization::kThreadSafe,
+                  const InstrumentationLibrary &instrumentation_library =
+                      InstrumentationLibrary::Get(""),
+                  std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+                  DeferredSamplingPredicate deferred_sampling_predicate = nullptr,
+                  std::shared_ptr<IdGenerator> id_generator =
+                      std::make_shared<RandomIdGenerator>()) noexcept
+      : processor_{processor},
+        span_synchronization_{span_synchronization},
+        instrumentation_library_{instrumentation_library},
+        sampler_{std::move(sampler)},
+        deferred_sampling_predicate_{std::move(deferred_sampling_predicate)},
+        id_generator_{std::move(id_generator)}
+  {}
 
   /**
    * Set the span processor associated with this tracer.
@@ -35,6 +95,43 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    */
   std::shared_ptr<SpanProcessor> GetProcessor() const noexcept;
 
+  /**
+   * @return How the spans started by this tracer guard their data against
+   * concurrent access.
+   */
+  SpanSynchronization GetSpanSynchronization() const noexcept { return span_synchronization_; }
+
+  /**
+   * @return The library whose spans this tracer starts.
+   */
+  const InstrumentationLibrary &GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_;
+  }
+
+  /**
+   * @return The sampler that decides which spans are recorded.
+   */
+  const std::shared_ptr<Sampler> &GetSampler() const noexcept { return sampler_; }
+
+  /**
+   * @return The predicate that decides which deferred spans are recorded.
+   */
+  const DeferredSamplingPredicate &GetDeferredSamplingPredicate() const noexcept
+  {
+    return deferred_sampling_predicate_;
+  }
+
+  /**
+   * @return The generator of the trace and span ids of new spans.
+   */
+  IdGenerator &GetIdGenerator() const noexcept { return *id_generator_; }
+
+  /**
+   * Start a span. The sampler is asked first; spans it doesn't record don't
+   * create a recordable, copy attributes or call the processor, unless the
+   * deferred sampling predicate keeps them when they end.
+   */
   nostd::unique_ptr<trace_api::Span> StartSpan(
       nostd::string_view name,
       const trace_api::KeyValueIterable &attributes,
@@ -46,6 +143,11 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
 
 private:
   opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
+  const SpanSynchronization span_synchronization_;
+  const InstrumentationLibrary &instrumentation_library_;
+  const std::shared_ptr<Sampler> sampler_;
+  const DeferredSamplingPredicate deferred_sampling_predicate_;
+  const std::shared_ptr<IdGenerator> id_generator_;
 };
 }  // namespace trace
 }  // namespace sdk
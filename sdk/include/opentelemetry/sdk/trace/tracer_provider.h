@@ -1,11 +1,17 @@
 #pragma once
 
-#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/sdk/trace/id_generator.h"
 #include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/sdk/trace/random_id_generator.h"
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/sdk/trace/tracer.h"
 #include "opentelemetry/trace/tracer_provider.h"
 
@@ -21,15 +27,39 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    * Initialize a new tracer provider.
    * @param processor The span processor for this tracer provider. This must
    * not be a nullptr.
+   * @param sampler The sampler for the tracers of this tracer provider. This
+   * must not be a nullptr.
+   * @param deferred_sampling_predicate The deferred sampling predicate for the
+   * tracers of this tracer provider.
+   * @param id_generator The id generator for the tracers of this tracer
+   * provider. This must not be a nullptr.
    */
-  explicit TracerProvider(std::shared_ptr<SpanProcessor> processor) noexcept;
+  explicit TracerProvider(std::shared_ptr<SpanProcessor> processor,
+                          std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+                          DeferredSamplingPredicate deferred_sampling_predicate = nullptr,
+                          std::shared_ptr<IdGenerator> id_generator =
+                              std::make_shared<RandomIdGenerator>()) noexcept;
 
+  /**
+   * Obtain the tracer of an instrumentation library. Every name and version
+   * gets its own tracer, which is created on first use and returned again by
+   * later calls.
+   *
+   * Looking up an existing tracer takes no mutex, but it still copies the
+   * tracer's shared pointer, which atomically updates a reference count that
+   * every thread using the library shares. Libraries should therefore keep the
+   * returned tracer rather than call this per span.
+   *
+   * If a new tracer can't be allocated, a no-op tracer is returned instead,
+   * and the next call tries again.
+   */
   opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> GetTracer(
       nostd::string_view library_name,
       nostd::string_view library_version = "") noexcept override;
 
   /**
-   * Set the span processor associated with this tracer provider.
+   * Set the span processor associated with this tracer provider and all of
+   * its tracers.
    * @param processor The new span processor for this tracer provider. This
    * must not be a nullptr.
    */
@@ -41,9 +71,45 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    */
   std::shared_ptr<SpanProcessor> GetProcessor() const noexcept;
 
+  /**
+   * Obtain the sampler associated with this tracer provider.
+   * @return The sampler for the tracers of this tracer provider.
+   */
+  const std::shared_ptr<Sampler> &GetSampler() const noexcept { return sampler_; }
+
+  /**
+   * Obtain the id generator associated with this tracer provider.
+   * @return The id generator for the tracers of this tracer provider.
+   */
+  const std::shared_ptr<IdGenerator> &GetIdGenerator() const noexcept { return id_generator_; }
+
 private:
+  using TracerList = std::vector<std::shared_ptr<Tracer>>;
+
   opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
-  std::shared_ptr<opentelemetry::trace::Tracer> tracer_;
+  const std::shared_ptr<Sampler> sampler_;
+  const DeferredSamplingPredicate deferred_sampling_predicate_;
+  const std::shared_ptr<IdGenerator> id_generator_;
+
+  // The tracers created so far. The list is immutable, and replaced by a
+  // copy whenever a tracer is added, so lookups only need to load it.
+  opentelemetry::sdk::AtomicSharedPtr<const TracerList> tracers_;
+
+  // Serializes adding tracers and setting the processor, so that no tracer
+  // misses a new processor.
+  std::mutex mutex_;
+
+  /**
+   * Create the tracer of an instrumentation library, unless another thread
+   * created it first.
+   * @return the tracer, or nullptr if it couldn't be allocated
+   */
+  std::shared_ptr<Tracer> CreateTracer(nostd::string_view library_name,
+                                       nostd::string_view library_version) noexcept;
+
+  static std::shared_ptr<Tracer> FindTracer(const TracerList &tracers,
+                                            nostd::string_view library_name,
+                                            nostd::string_view library_version) noexcept;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -15,15 +16,26 @@ namespace common
 {
 /*
  * A lock-free circular buffer that supports multiple concurrent producers
- * and a single consumer.
+ * and a single consumer. Several consumers can drain the buffer concurrently
+ * with ConsumeConcurrently.
+ *
+ * The number of slots is rounded up to a power of two so that indexes can be
+ * computed with a mask; max_size() still reports the requested size.
  */
 template <class T>
 class CircularBuffer
 {
 public:
-  explicit CircularBuffer(size_t max_size)
-      : data_{new AtomicUniquePtr<T>[max_size + 1]}, capacity_{max_size + 1}
-  {}
+  explicit CircularBuffer(size_t max_size) : max_size_{max_size}
+  {
+    capacity_ = 1;
+    while (capacity_ < max_size)
+    {
+      capacity_ *= 2;
+    }
+    mask_ = capacity_ - 1;
+    data_.reset(new AtomicUniquePtr<T>[capacity_]);
+  }
 
   /**
    * @return a range of the elements in the circular buffer
@@ -55,6 +67,40 @@ class CircularBuffer
     callback(range);
   }
 
+  /**
+   * Consume up to n elements from the circular buffer's tail. Unlike Consume,
+   * this can be called from several threads at once: every call claims a
+   * disjoint range of elements.
+   * @param n the maximum number of elements to consume
+   * @param callback the callback to invoke with a CircularBufferRange of
+   * AtomicUniquePtr to the claimed elements.
+   * @return the number of elements consumed
+   *
+   * Note: The callback must set the passed AtomicUniquePtrs to null.
+   *
+   * Note: While threads might be calling this method, the other methods that
+   * consume elements, as well as Peek, must not be called.
+   */
+  template <class Callback>
+  size_t ConsumeConcurrently(size_t n, Callback callback) noexcept
+  {
+    uint64_t tail = tail_;
+    uint64_t count;
+    do
+    {
+      uint64_t head = head_;
+      count         = std::min<uint64_t>(head - tail, n);
+      if (count == 0)
+      {
+        return 0;
+      }
+    } while (!tail_.compare_exchange_weak(tail, tail + count));
+    auto range = RangeAt(tail, count);
+    static_assert(noexcept(callback(range)), "callback not allowed to throw");
+    callback(range);
+    return count;
+  }
+
   /**
    * Consume elements from the circular buffer's tail.
    * @param n the number of elements to consume
@@ -85,12 +131,12 @@ class CircularBuffer
       uint64_t head = head_;
 
       // The circular buffer is full, so return false.
-      if (head - tail >= capacity_ - 1)
+      if (head - tail >= max_size_)
       {
         return false;
       }
 
-      uint64_t head_index = head % capacity_;
+      uint64_t head_index = head & mask_;
       if (data_[head_index].SwapIfNull(ptr))
       {
         auto new_head      = head + 1;
@@ -113,6 +159,78 @@ class CircularBuffer
     return true;
   }
 
+  /**
+   * Adds several elements into the circular buffer, reserving their slots with
+   * a single update of the head index. Either all or none of the elements are
+   * added.
+   * @param ptrs pointers to the elements to add
+   * @return true if the elements were successfully added; false, otherwise.
+   */
+  bool AddMany(nostd::span<std::unique_ptr<T>> ptrs) noexcept
+  {
+    uint64_t n = ptrs.size();
+    if (n == 0)
+    {
+      return true;
+    }
+    while (true)
+    {
+      uint64_t tail = tail_;
+      uint64_t head = head_;
+
+      // There isn't room for all of the elements, so return false.
+      if (head - tail + n > max_size_)
+      {
+        return false;
+      }
+
+      uint64_t num_swapped = 0;
+      while (num_swapped < n &&
+             data_[(head + num_swapped) & mask_].SwapIfNull(ptrs[num_swapped]))
+      {
+        ++num_swapped;
+      }
+      if (num_swapped == n)
+      {
+        auto expected_head = head;
+        if (head_.compare_exchange_weak(expected_head, head + n, std::memory_order_release,
+                                        std::memory_order_relaxed))
+        {
+          return true;
+        }
+      }
+
+      // Either a slot was still taken or the head moved on, so undo the swaps
+      // and attempt to add again.
+      while (num_swapped > 0)
+      {
+        --num_swapped;
+        data_[(head + num_swapped) & mask_].Swap(ptrs[num_swapped]);
+      }
+    }
+  }
+
+  /**
+   * Consume all elements in the circular buffer.
+   * @param callback the callback to invoke with a CircularBufferRange of
+   * AtomicUniquePtr to the consumed elements.
+   * @return the number of elements consumed
+   *
+   * Note: The callback must set the passed AtomicUniquePtrs to null.
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  template <class Callback>
+  size_t ConsumeAll(Callback callback) noexcept
+  {
+    auto n = size();
+    if (n > 0)
+    {
+      Consume(n, callback);
+    }
+    return n;
+  }
+
   /**
    * Clear the circular buffer.
    *
@@ -123,7 +241,7 @@ class CircularBuffer
   /**
    * @return the maximum number of bytes that can be stored in the buffer.
    */
-  size_t max_size() const noexcept { return capacity_ - 1; }
+  size_t max_size() const noexcept { return max_size_; }
 
   /**
    * @return true if the buffer is empty.
@@ -155,27 +273,46 @@ class CircularBuffer
   uint64_t production_count() const noexcept { return head_; }
 
 private:
+  static const size_t kCacheLineSize = 64;
+
   std::unique_ptr<AtomicUniquePtr<T>[]> data_;
+  size_t max_size_;
   size_t capacity_;
+  uint64_t mask_;
+
+  // head_ is written by producers and tail_ by the consumer, so they're kept
+  // on separate cache lines from each other and from the read-only members.
+  char head_padding_[kCacheLineSize];
   std::atomic<uint64_t> head_{0};
+  char tail_padding_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
   std::atomic<uint64_t> tail_{0};
+  char end_padding_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
 
   CircularBufferRange<AtomicUniquePtr<T>> PeekImpl() noexcept
   {
-    uint64_t tail_index = tail_ % capacity_;
-    uint64_t head_index = head_ % capacity_;
-    if (head_index == tail_index)
+    uint64_t tail = tail_;
+    uint64_t head = head_;
+    if (head == tail)
     {
       return {};
     }
-    auto data = data_.get();
-    if (tail_index < head_index)
+    return RangeAt(tail, head - tail);
+  }
+
+  /**
+   * @return the range of size elements starting at position tail
+   */
+  CircularBufferRange<AtomicUniquePtr<T>> RangeAt(uint64_t tail, uint64_t size) noexcept
+  {
+    auto data       = data_.get();
+    auto tail_index = tail & mask_;
+    if (tail_index + size <= capacity_)
     {
       return CircularBufferRange<AtomicUniquePtr<T>>{
-          nostd::span<AtomicUniquePtr<T>>{data + tail_index, head_index - tail_index}};
+          nostd::span<AtomicUniquePtr<T>>{data + tail_index, size}};
     }
     return {nostd::span<AtomicUniquePtr<T>>{data + tail_index, capacity_ - tail_index},
-            nostd::span<AtomicUniquePtr<T>>{data, head_index}};
+            nostd::span<AtomicUniquePtr<T>>{data, size - (capacity_ - tail_index)}};
   }
 };
 }  // namespace common
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/*
+ * A lock-free circular buffer that supports multiple concurrent producers
+ * and a single consumer, and that stores its elements in place.
+ *
+ * Unlike CircularBuffer, elements don't need to be heap-allocated by the
+ * producer and deleted by the consumer, which makes it a better fit for small
+ * values such as pointers or IDs.
+ *
+ * Every slot carries a sequence number that tells producers and the consumer
+ * whose turn it is to access the slot (see Dmitry Vyukov's bounded MPMC queue).
+ * For position p, a slot with sequence p is free to be written, and a slot
+ * with sequence p + 1 holds an element that is ready to be consumed.
+ */
+template <class T>
+class InlineCircularBuffer
+{
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "InlineCircularBuffer elements must be nothrow move constructible");
+
+public:
+  /**
+   * @param min_capacity the minimum number of elements that can be stored in
+   * the buffer; it's rounded up to the next power of two, see capacity().
+   */
+  explicit InlineCircularBuffer(size_t min_capacity)
+  {
+    capacity_ = 1;
+    while (capacity_ < min_capacity)
+    {
+      capacity_ *= 2;
+    }
+    mask_ = capacity_ - 1;
+    slots_.reset(new Slot[capacity_]);
+    for (size_t i = 0; i < capacity_; ++i)
+    {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  InlineCircularBuffer(const InlineCircularBuffer &) = delete;
+  InlineCircularBuffer &operator=(const InlineCircularBuffer &) = delete;
+
+  ~InlineCircularBuffer() { Clear(); }
+
+  /**
+   * Adds an element into the circular buffer.
+   * @param value the element to add; it's only moved from if it was added
+   * @return true if the element was successfully added; false, otherwise.
+   */
+  bool Add(T &value) noexcept
+  {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+      slot          = &slots_[head & mask_];
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff     = static_cast<int64_t>(sequence - head);
+      if (diff == 0)
+      {
+        if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        // The slot still holds the element from one lap ago, so the buffer is
+        // full.
+        return false;
+      }
+      else
+      {
+        head = head_.load(std::memory_order_relaxed);
+      }
+    }
+    new (&slot->storage) T(std::move(value));
+    slot->sequence.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Add(T &&value) noexcept { return this->Add(value); }
+
+  /**
+   * Consume up to n elements from the circular buffer's tail. Consumption stops
+   * early at an element that is still being written by a producer.
+   * @param n the maximum number of elements to consume
+   * @param callback the callback to invoke with an rvalue reference to each
+   * consumed element.
+   * @return the number of elements consumed
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  template <class Callback>
+  size_t Consume(size_t n, Callback callback) noexcept
+  {
+    static_assert(noexcept(callback(std::declval<T &&>())), "callback not allowed to throw");
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    size_t i      = 0;
+    for (; i < n; ++i, ++tail)
+    {
+      auto &slot = slots_[tail & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+      {
+        break;
+      }
+      auto &value = *reinterpret_cast<T *>(&slot.storage);
+      callback(std::move(value));
+      value.~T();
+      slot.sequence.store(tail + capacity_, std::memory_order_release);
+    }
+    tail_.store(tail, std::memory_order_release);
+    return i;
+  }
+
+  /**
+   * Clear the circular buffer.
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  void Clear() noexcept
+  {
+    Consume(size(), [](T &&) noexcept {});
+  }
+
+  /**
+   * @return the number of elements that can be stored in the buffer. Unlike
+   * CircularBuffer::max_size, this is the requested size rounded up to a power
+   * of two, because fullness is detected from the slots' sequence numbers
+   * rather than by comparing head and tail.
+   */
+  size_t capacity() const noexcept { return capacity_; }
+
+  /**
+   * @return true if the buffer is empty.
+   */
+  bool empty() const noexcept { return head_ == tail_; }
+
+  /**
+   * @return the number of elements stored in the circular buffer, including
+   * elements that are still being written.
+   *
+   * Note: this method will only return a correct snapshot of the size if called
+   * from the consumer thread.
+   */
+  size_t size() const noexcept
+  {
+    uint64_t tail = tail_;
+    uint64_t head = head_;
+    return head - tail;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  static const size_t kCacheLineSize = 64;
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t capacity_;
+  uint64_t mask_;
+
+  // head_ is written by producers and tail_ by the consumer, so they're kept
+  // on separate cache lines from each other and from the read-only members.
+  char head_padding_[kCacheLineSize];
+  std::atomic<uint64_t> head_{0};
+  char tail_padding_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> tail_{0};
+  char end_padding_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "opentelemetry/sdk/common/thread_number.h"
+#include "opentelemetry/version.h"
+#include "src/common/circular_buffer.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/*
+ * A lock-free queue made of several CircularBuffer shards that supports
+ * multiple concurrent producers and a single consumer, or several consumers
+ * using ConsumeConcurrently.
+ *
+ * Every producer thread is assigned to one shard, so that producers only
+ * contend on the head index of their own shard instead of on a single shared
+ * one. The consumer drains the shards round-robin.
+ *
+ * Elements added by the same thread are consumed in the order they were added;
+ * there is no ordering between elements added by different threads. Likewise,
+ * "oldest" only has a meaning within a shard, see AddEvictingOldest.
+ */
+template <class T>
+class ShardedCircularBuffer
+{
+public:
+  /**
+   * @param max_size the maximum number of elements in the queue. The capacity
+   * is divided between the shards so that their sizes add up to max_size and
+   * differ by at most one; a single thread can fill only its own shard.
+   * @param num_shards the number of shards; a value of 1 makes the queue behave
+   * like a single CircularBuffer. It's reduced to max_size if that's smaller,
+   * so that every shard holds at least one element.
+   */
+  ShardedCircularBuffer(size_t max_size, size_t num_shards)
+  {
+    max_size        = std::max<size_t>(max_size, 1);
+    num_shards      = std::min(std::max<size_t>(num_shards, 1), max_size);
+    auto shard_size = max_size / num_shards;
+    auto remainder  = max_size % num_shards;
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i)
+    {
+      shards_.emplace_back(new CircularBuffer<T>{shard_size + (i < remainder ? 1 : 0)});
+    }
+  }
+
+  /**
+   * Adds an element into the shard of the calling thread.
+   * @param ptr a pointer to the element to add
+   * @return true if the element was successfully added; false, otherwise.
+   */
+  bool Add(std::unique_ptr<T> &ptr) noexcept { return GetShard().Add(ptr); }
+
+  /**
+   * Adds several elements into the shard of the calling thread. Either all or
+   * none of the elements are added.
+   * @param ptrs pointers to the elements to add
+   * @return true if the elements were successfully added; false, otherwise.
+   */
+  bool AddMany(nostd::span<std::unique_ptr<T>> ptrs) noexcept { return GetShard().AddMany(ptrs); }
+
+  /**
+   * Adds an element into the shard of the calling thread, consuming the oldest
+   * elements of that shard one at a time while it's full. Other shards are
+   * never touched, so the evicted elements are the oldest ones of the shard,
+   * not necessarily of the whole queue.
+   * @param ptr a pointer to the element to add
+   * @param max_evictions the maximum number of elements to consume before
+   * giving up, in case other producers keep filling the shard
+   * @param callback the callback to invoke with a CircularBufferRange of
+   * AtomicUniquePtr to every consumed element.
+   * @return true if the element was successfully added; false, otherwise.
+   *
+   * Note: The callback must set the passed AtomicUniquePtrs to null.
+   *
+   * Note: While threads might be calling this method, Consume and Clear must
+   * not be called.
+   */
+  template <class Callback>
+  bool AddEvictingOldest(std::unique_ptr<T> &ptr, size_t max_evictions, Callback callback) noexcept
+  {
+    auto &shard = GetShard();
+    for (size_t num_evictions = 0;; ++num_evictions)
+    {
+      if (shard.Add(ptr))
+      {
+        return true;
+      }
+      if (num_evictions == max_evictions)
+      {
+        return false;
+      }
+      shard.ConsumeConcurrently(1, callback);
+    }
+  }
+
+  /**
+   * Consume up to n elements, visiting the shards round-robin.
+   * @param n the maximum number of elements to consume
+   * @param callback the callback to invoke with a CircularBufferRange of
+   * AtomicUniquePtr for each shard that elements are consumed from.
+   * @return the number of elements consumed
+   *
+   * Note: The callback must set the passed AtomicUniquePtrs to null.
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  template <class Callback>
+  size_t Consume(size_t n, Callback callback) noexcept
+  {
+    size_t num_consumed = 0;
+    for (size_t i = 0; i < shards_.size() && num_consumed < n; ++i)
+    {
+      auto shard_index = next_shard_index_.load(std::memory_order_relaxed);
+      auto &shard      = *shards_[shard_index];
+      next_shard_index_.store((shard_index + 1) % shards_.size(), std::memory_order_relaxed);
+      auto count = std::min(shard.size(), n - num_consumed);
+      if (count == 0)
+      {
+        continue;
+      }
+      shard.Consume(count, callback);
+      num_consumed += count;
+    }
+    return num_consumed;
+  }
+
+  /**
+   * Consume up to n elements, visiting the shards round-robin. Unlike Consume,
+   * this can be called from several threads at once: every call claims
+   * disjoint ranges of elements.
+   * @param n the maximum number of elements to consume
+   * @param callback the callback to invoke with a CircularBufferRange of
+   * AtomicUniquePtr for each range of elements claimed.
+   * @return the number of elements consumed
+   *
+   * Note: The callback must set the passed AtomicUniquePtrs to null.
+   *
+   * Note: While threads might be calling this method, Consume and Clear must
+   * not be called.
+   */
+  template <class Callback>
+  size_t ConsumeConcurrently(size_t n, Callback callback) noexcept
+  {
+    size_t num_consumed = 0;
+    auto first_shard    = next_shard_index_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < shards_.size() && num_consumed < n; ++i)
+    {
+      auto &shard = *shards_[(first_shard + i) % shards_.size()];
+      num_consumed += shard.ConsumeConcurrently(n - num_consumed, callback);
+    }
+    return num_consumed;
+  }
+
+  /**
+   * Clear the queue.
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  void Clear() noexcept
+  {
+    for (auto &shard : shards_)
+    {
+      shard->Clear();
+    }
+  }
+
+  /**
+   * @return the maximum number of elements that can be stored in the queue.
+   */
+  size_t max_size() const noexcept
+  {
+    size_t result = 0;
+    for (auto &shard : shards_)
+    {
+      result += shard->max_size();
+    }
+    return result;
+  }
+
+  /**
+   * @return the number of shards.
+   */
+  size_t num_shards() const noexcept { return shards_.size(); }
+
+  /**
+   * @return true if every shard is empty.
+   */
+  bool empty() const noexcept
+  {
+    for (auto &shard : shards_)
+    {
+      if (!shard->empty())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return the number of elements stored in the queue.
+   *
+   * Note: this method will only return a correct snapshot of the size if called
+   * from the consumer thread.
+   */
+  size_t size() const noexcept
+  {
+    size_t result = 0;
+    for (auto &shard : shards_)
+    {
+      result += shard->size();
+    }
+    return result;
+  }
+
+private:
+  std::vector<std::unique_ptr<CircularBuffer<T>>> shards_;
+  std::atomic<size_t> next_shard_index_{0};
+
+  CircularBuffer<T> &GetShard() noexcept
+  {
+    if (shards_.size() == 1)
+    {
+      return *shards_.front();
+    }
+    // Thread numbers are handed out sequentially, so threads are spread
+    // evenly across the shards.
+    return *shards_[GetThreadNumber() % shards_.size()];
+  }
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
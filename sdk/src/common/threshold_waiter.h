@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/*
+ * Lets the consumer of a lock-free queue sleep until a number of elements are
+ * queued or a deadline passes.
+ *
+ * The consumer announces the queue size it waits for before going to sleep.
+ * Producers only take the lock and notify the consumer when they see that
+ * size reached while the consumer is asleep, so adding an element otherwise
+ * costs a fence and an atomic load.
+ */
+class ThresholdWaiter
+{
+public:
+  /**
+   * Block until a producer reports that at least threshold elements are
+   * queued, Wake is called, or the deadline passes.
+   * @param threshold the number of queued elements to wait for
+   * @param deadline the time to wait until
+   * @param queue_size a callable that returns the number of queued elements as
+   * an unsigned integer
+   * @return true if woken up before the deadline; false, otherwise.
+   *
+   * Note: This method must only be called from the consumer thread.
+   */
+  template <class SizeFunction>
+  bool WaitUntil(size_t threshold,
+                 std::chrono::steady_clock::time_point deadline,
+                 SizeFunction queue_size) noexcept
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (!wake_requested_)
+    {
+      threshold_.store(threshold);
+
+      // Pairs with the fence in NotifyAdded: either the producer sees the
+      // threshold, or the consumer sees the producer's element.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (GetQueueSize(queue_size) < threshold)
+      {
+        cv_.wait_until(lock, deadline, [this] {
+          return wake_requested_ || threshold_.load(std::memory_order_relaxed) == kNotWaiting;
+        });
+      }
+      else
+      {
+        threshold_.store(kNotWaiting, std::memory_order_relaxed);
+      }
+    }
+    bool is_woken = wake_requested_ || threshold_.load(std::memory_order_relaxed) == kNotWaiting;
+    threshold_.store(kNotWaiting, std::memory_order_relaxed);
+    wake_requested_ = false;
+    return is_woken;
+  }
+
+  /**
+   * Wake the consumer up if it waits for no more elements than are queued.
+   * @param queue_size a callable that returns the number of queued elements as
+   * an unsigned integer; it's only invoked while the consumer is waiting.
+   *
+   * Note: This method must be called by producers after adding an element.
+   */
+  template <class SizeFunction>
+  void NotifyAdded(SizeFunction queue_size) noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto threshold = threshold_.load(std::memory_order_relaxed);
+    if (threshold == kNotWaiting || GetQueueSize(queue_size) < threshold)
+    {
+      return;
+    }
+
+    // Only the producer that claims the threshold notifies.
+    if (threshold_.compare_exchange_strong(threshold, kNotWaiting))
+    {
+      {
+        std::lock_guard<std::mutex> guard{mutex_};
+      }
+      cv_.notify_one();
+    }
+  }
+
+  /**
+   * Wake the consumer up regardless of the queue size. If the consumer isn't
+   * waiting, its next call to WaitUntil returns immediately.
+   */
+  void Wake() noexcept
+  {
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      wake_requested_ = true;
+    }
+    cv_.notify_one();
+  }
+
+private:
+  static constexpr size_t kNotWaiting = std::numeric_limits<size_t>::max();
+
+  std::atomic<size_t> threshold_{kNotWaiting};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool wake_requested_{false};
+
+  template <class SizeFunction>
+  static size_t GetQueueSize(SizeFunction &queue_size) noexcept
+  {
+    static_assert(std::is_unsigned<decltype(queue_size())>::value,
+                  "queue_size must return an unsigned integer");
+    return static_cast<size_t>(queue_size());
+  }
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,139 @@
+#include "opentelemetry/sdk/trace/arena_span_data.h"
+
+#include <new>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+// The alternatives of AttributeValue, in order.
+enum AttributeValueIndex : size_t
+{
+  kBool,
+  kInt,
+  kInt64,
+  kUInt,
+  kUInt64,
+  kDouble,
+  kString,
+  kBoolArray,
+  kIntArray,
+  kInt64Array,
+  kUIntArray,
+  kUInt64Array,
+  kDoubleArray,
+  kStringArray
+};
+
+static_assert(nostd::variant_size<opentelemetry::common::AttributeValue>::value ==
+                  kStringArray + 1,
+              "AttributeValueIndex must list every alternative of AttributeValue");
+}  // namespace
+
+bool ArenaSpanData::ForEachAttribute(
+    nostd::function_ref<bool(nostd::string_view, const opentelemetry::common::AttributeValue &)>
+        callback) const noexcept
+{
+  for (auto attribute = first_attribute_; attribute != nullptr; attribute = attribute->next)
+  {
+    if (!callback(attribute->key, attribute->value))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ArenaSpanData::SetAttribute(nostd::string_view key,
+                                 const opentelemetry::common::AttributeValue &&value) noexcept
+{
+  // Spans carry few attributes, so a linear search is cheaper than hashing.
+  for (auto attribute = first_attribute_; attribute != nullptr; attribute = attribute->next)
+  {
+    if (attribute->key == key)
+    {
+      attribute->value = CopyAttributeValue(value);
+      return;
+    }
+  }
+
+  auto memory = arena_.Allocate(sizeof(Attribute), alignof(Attribute));
+  if (memory == nullptr)
+  {
+    return;
+  }
+  auto attribute =
+      new (memory) Attribute{arena_.CopyString(key), CopyAttributeValue(value), nullptr};
+  if (last_attribute_ == nullptr)
+  {
+    first_attribute_ = attribute;
+  }
+  else
+  {
+    last_attribute_->next = attribute;
+  }
+  last_attribute_ = attribute;
+  ++num_attributes_;
+}
+
+void ArenaSpanData::Reset() noexcept
+{
+  arena_.Reset();
+  trace_id_                = opentelemetry::trace::TraceId();
+  span_id_                 = opentelemetry::trace::SpanId();
+  parent_span_id_          = opentelemetry::trace::SpanId();
+  start_time_              = core::SystemTimestamp();
+  duration_                = std::chrono::nanoseconds(0);
+  instrumentation_library_ = nullptr;
+  name_                    = nostd::string_view();
+  status_code_             = opentelemetry::trace::CanonicalCode::OK;
+  status_desc_             = nostd::string_view();
+  first_attribute_         = nullptr;
+  last_attribute_          = nullptr;
+  num_attributes_          = 0;
+}
+
+opentelemetry::common::AttributeValue ArenaSpanData::CopyAttributeValue(
+    const opentelemetry::common::AttributeValue &value) noexcept
+{
+  switch (value.index())
+  {
+    case kString:
+      return arena_.CopyString(nostd::get<kString>(value));
+    case kBoolArray:
+      return arena_.CopySpan(nostd::get<kBoolArray>(value));
+    case kIntArray:
+      return arena_.CopySpan(nostd::get<kIntArray>(value));
+    case kInt64Array:
+      return arena_.CopySpan(nostd::get<kInt64Array>(value));
+    case kUIntArray:
+      return arena_.CopySpan(nostd::get<kUIntArray>(value));
+    case kUInt64Array:
+      return arena_.CopySpan(nostd::get<kUInt64Array>(value));
+    case kDoubleArray:
+      return arena_.CopySpan(nostd::get<kDoubleArray>(value));
+    case kStringArray: {
+      auto strings = nostd::get<kStringArray>(value);
+      auto copy    = static_cast<nostd::string_view *>(arena_.Allocate(
+          strings.size() * sizeof(nostd::string_view), alignof(nostd::string_view)));
+      if (copy == nullptr)
+      {
+        return nostd::span<const nostd::string_view>{};
+      }
+      for (size_t i = 0; i < strings.size(); ++i)
+      {
+        new (copy + i) nostd::string_view{arena_.CopyString(strings[i])};
+      }
+      return nostd::span<const nostd::string_view>{copy, strings.size()};
+    }
+    default:
+      // Scalars don't refer to the caller's memory.
+      return value;
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,189 @@
+#include "opentelemetry/sdk/trace/attribute_key_table.h"
+
+#include <algorithm>
+#include <new>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+size_t Hash(nostd::string_view key) noexcept
+{
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < key.size(); ++i)
+  {
+    hash = (hash ^ static_cast<unsigned char>(key[i])) * 1099511628211ull;
+  }
+  return static_cast<size_t>(hash ^ (hash >> 32));
+}
+}  // namespace
+
+const AttributeKeyId AttributeKeyTable::kInvalidKeyId;
+const size_t AttributeKeyTable::kMaxKeys;
+const size_t AttributeKeyTable::kInitialIndexSize;
+const size_t AttributeKeyTable::kMaxIndexes;
+
+/**
+ * An open-addressing hash table of key ids. Every slot holds an id plus one,
+ * or zero if it's empty.
+ */
+struct AttributeKeyTable::Index
+{
+  explicit Index(size_t size) noexcept
+      : mask{size - 1}, slots{new (std::nothrow) std::atomic<uint32_t>[size]}
+  {
+    for (size_t i = 0; slots != nullptr && i < size; ++i)
+    {
+      slots[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  size_t mask;
+  std::unique_ptr<std::atomic<uint32_t>[]> slots;
+};
+
+AttributeKeyTable::AttributeKeyTable() noexcept
+{
+  for (auto &chunk : chunks_)
+  {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+AttributeKeyTable::~AttributeKeyTable()
+{
+  for (auto &chunk : chunks_)
+  {
+    delete[] chunk.load(std::memory_order_relaxed);
+  }
+}
+
+AttributeKeyTable &AttributeKeyTable::GetGlobal() noexcept
+{
+  // Never destroyed, so that recordables destroyed during static destruction
+  // can still look up their keys.
+  static auto table = new AttributeKeyTable;
+  return *table;
+}
+
+AttributeKeyId AttributeKeyTable::Intern(nostd::string_view key) noexcept
+{
+  auto hash = Hash(key);
+  auto id   = FindInIndex(index_.load(std::memory_order_acquire), key, hash);
+  if (id != kInvalidKeyId)
+  {
+    return id;
+  }
+
+  std::lock_guard<std::mutex> guard{mutex_};
+  id = FindInIndex(index_.load(std::memory_order_relaxed), key, hash);
+  if (id != kInvalidKeyId)
+  {
+    return id;
+  }
+  auto size = size_.load(std::memory_order_relaxed);
+  if (size == kMaxKeys)
+  {
+    return kInvalidKeyId;
+  }
+  auto &chunk = chunks_[size >> kChunkBits];
+  if (chunk.load(std::memory_order_relaxed) == nullptr)
+  {
+    auto keys = new (std::nothrow) Key[kChunkSize];
+    if (keys == nullptr)
+    {
+      return kInvalidKeyId;
+    }
+    chunk.store(keys, std::memory_order_release);
+  }
+  auto &entry = chunk.load(std::memory_order_relaxed)[size & kChunkMask];
+  entry.data.reset(new (std::nothrow) char[key.size()]);
+  if (entry.data == nullptr)
+  {
+    return kInvalidKeyId;
+  }
+  std::copy(key.data(), key.data() + key.size(), entry.data.get());
+  entry.size = key.size();
+  entry.hash = hash;
+  id         = static_cast<AttributeKeyId>(size);
+  if (!AddToIndex(id))
+  {
+    return kInvalidKeyId;
+  }
+  size_.store(size + 1, std::memory_order_release);
+  return id;
+}
+
+AttributeKeyId AttributeKeyTable::Find(nostd::string_view key) const noexcept
+{
+  return FindInIndex(index_.load(std::memory_order_acquire), key, Hash(key));
+}
+
+AttributeKeyId AttributeKeyTable::FindInIndex(const Index *index,
+                                              nostd::string_view key,
+                                              size_t hash) const noexcept
+{
+  if (index == nullptr)
+  {
+    return kInvalidKeyId;
+  }
+  for (auto slot = hash & index->mask;; slot = (slot + 1) & index->mask)
+  {
+    auto value = index->slots[slot].load(std::memory_order_acquire);
+    if (value == 0)
+    {
+      return kInvalidKeyId;
+    }
+    auto &entry = chunks_[(value - 1) >> kChunkBits].load(
+        std::memory_order_relaxed)[(value - 1) & kChunkMask];
+    if (entry.hash == hash && nostd::string_view{entry.data.get(), entry.size} == key)
+    {
+      return value - 1;
+    }
+  }
+}
+
+bool AttributeKeyTable::AddToIndex(AttributeKeyId id) noexcept
+{
+  auto index = index_.load(std::memory_order_relaxed);
+
+  // Keep the index at most half full, so that probe sequences stay short.
+  if (index == nullptr || 2 * (id + 1) > index->mask + 1)
+  {
+    auto larger_size = index == nullptr ? kInitialIndexSize : 2 * (index->mask + 1);
+    std::unique_ptr<Index> larger{new (std::nothrow) Index{larger_size}};
+    if (larger == nullptr || larger->slots == nullptr)
+    {
+      return false;
+    }
+    index = larger.get();
+    for (AttributeKeyId i = 0; i < id; ++i)
+    {
+      auto hash = chunks_[i >> kChunkBits].load(std::memory_order_relaxed)[i & kChunkMask].hash;
+      auto slot = hash & index->mask;
+      while (index->slots[slot].load(std::memory_order_relaxed) != 0)
+      {
+        slot = (slot + 1) & index->mask;
+      }
+      index->slots[slot].store(i + 1, std::memory_order_relaxed);
+    }
+    indexes_[num_indexes_++] = std::move(larger);
+    index_.store(index, std::memory_order_release);
+  }
+
+  auto hash = chunks_[id >> kChunkBits].load(std::memory_order_relaxed)[id & kChunkMask].hash;
+  auto slot = hash & index->mask;
+  while (index->slots[slot].load(std::memory_order_relaxed) != 0)
+  {
+    slot = (slot + 1) & index->mask;
+  }
+  index->slots[slot].store(id + 1, std::memory_order_release);
+  return true;
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
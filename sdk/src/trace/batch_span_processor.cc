@@ -0,0 +1,346 @@
+#include "opentelemetry/sdk/trace/batch_span_processor.h"
+
+#include <algorithm>
+
+#include "src/common/sharded_circular_buffer.h"
+#include "src/common/threshold_waiter.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+using common::AtomicUniquePtr;
+using common::CircularBufferRange;
+using common::ShardedCircularBuffer;
+using common::ThresholdWaiter;
+
+namespace
+{
+std::vector<std::unique_ptr<SpanExporter>> MakeExporterList(
+    std::unique_ptr<SpanExporter> &&exporter)
+{
+  std::vector<std::unique_ptr<SpanExporter>> result;
+  result.push_back(std::move(exporter));
+  return result;
+}
+}  // namespace
+
+BatchSpanProcessor::BatchSpanProcessor(std::unique_ptr<SpanExporter> &&exporter,
+                                       const BatchSpanProcessorOptions &options)
+    : BatchSpanProcessor(MakeExporterList(std::move(exporter)), options)
+{}
+
+BatchSpanProcessor::BatchSpanProcessor(std::vector<std::unique_ptr<SpanExporter>> &&exporters,
+                                       const BatchSpanProcessorOptions &options)
+    : exporters_{std::move(exporters)},
+      options_(options),
+      buffer_{new ShardedCircularBuffer<Recordable>{options.max_queue_size,
+                                                    options.num_queue_shards}},
+      waiter_{new ThresholdWaiter}
+{
+  options_.max_export_batch_size =
+      std::max<size_t>(1, std::min(options_.max_export_batch_size, options_.max_queue_size));
+  batches_.resize(exporters_.size());
+  for (auto &batch : batches_)
+  {
+    batch.reserve(options_.max_export_batch_size);
+  }
+
+  // The worker threads are started last so that they only ever observe a fully
+  // initialized processor.
+  for (size_t i = 0; i < exporters_.size(); ++i)
+  {
+    worker_threads_.emplace_back(&BatchSpanProcessor::DoBackgroundWork, this, i);
+  }
+}
+
+BatchSpanProcessor::~BatchSpanProcessor()
+{
+  Shutdown();
+}
+
+std::unique_ptr<Recordable> BatchSpanProcessor::MakeRecordable() noexcept
+{
+  return exporters_.front()->MakeRecordable();
+}
+
+void BatchSpanProcessor::OnStart(Recordable &span) noexcept
+{
+  (void)span;
+}
+
+void BatchSpanProcessor::OnEnd(std::unique_ptr<Recordable> &&span) noexcept
+{
+  if (is_shutdown_)
+  {
+    dropped_after_shutdown_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  if (!buffer_->Add(span))
+  {
+    switch (options_.backpressure_policy)
+    {
+      case BackpressurePolicy::kDropNewest:
+        dropped_newest_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      case BackpressurePolicy::kDropOldest:
+        // Only the shard that rejected the span is full, so room is made there.
+        if (!buffer_->AddEvictingOldest(
+                span, options_.max_export_batch_size,
+                [this](CircularBufferRange<AtomicUniquePtr<Recordable>> range) noexcept {
+                  range.ForEach([this](AtomicUniquePtr<Recordable> &ptr) {
+                    ptr.Reset();
+                    dropped_oldest_count_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                  });
+                }))
+        {
+          dropped_overflow_count_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        break;
+      case BackpressurePolicy::kBlock:
+        if (!AddBlocking(span))
+        {
+          dropped_after_block_count_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        break;
+    }
+  }
+
+  // Wake the worker up early once a full batch is available. This only costs a
+  // notification for the span that completes the batch.
+  waiter_->NotifyAdded([this] { return GetQueueSize(); });
+}
+
+bool BatchSpanProcessor::AddBlocking(std::unique_ptr<Recordable> &span) noexcept
+{
+  auto deadline = std::chrono::steady_clock::now() + options_.max_block_time;
+
+  // The worker only takes space_m_ to notify if it sees a blocked producer, so
+  // the producer has to announce itself before it re-checks the queue.
+  num_blocked_producers_.fetch_add(1);
+  bool is_added = false;
+  {
+    std::unique_lock<std::mutex> lock{space_m_};
+    while (!(is_added = buffer_->Add(span)) && !is_shutdown_)
+    {
+      waiter_->Wake();
+      if (space_cv_.wait_until(lock, deadline) == std::cv_status::timeout)
+      {
+        is_added = buffer_->Add(span);
+        break;
+      }
+    }
+  }
+  num_blocked_producers_.fetch_sub(1);
+  return is_added;
+}
+
+BatchSpanProcessorDropCounts BatchSpanProcessor::GetDropCounts() const noexcept
+{
+  BatchSpanProcessorDropCounts result;
+  result.dropped_newest         = dropped_newest_count_.load(std::memory_order_relaxed);
+  result.dropped_oldest         = dropped_oldest_count_.load(std::memory_order_relaxed);
+  result.dropped_overflow       = dropped_overflow_count_.load(std::memory_order_relaxed);
+  result.dropped_after_block    = dropped_after_block_count_.load(std::memory_order_relaxed);
+  result.dropped_after_shutdown = dropped_after_shutdown_count_.load(std::memory_order_relaxed);
+  return result;
+}
+
+uint64_t BatchSpanProcessor::GetDroppedSpanCount() const noexcept
+{
+  auto drop_counts = GetDropCounts();
+  return drop_counts.dropped_newest + drop_counts.dropped_oldest + drop_counts.dropped_overflow +
+         drop_counts.dropped_after_block + drop_counts.dropped_after_shutdown;
+}
+
+void BatchSpanProcessor::ForceFlush(std::chrono::microseconds timeout) noexcept
+{
+  if (is_shutdown_)
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> flush_lock{flush_m_};
+  auto flush_count = ++flush_requested_count_;
+  is_force_flush_  = true;
+  waiter_->Wake();
+
+  auto is_flushed = [this, flush_count] {
+    return flush_completed_count_ >= flush_count || is_shutdown_;
+  };
+  if (timeout == std::chrono::microseconds::zero())
+  {
+    while (!flush_cv_.wait_for(flush_lock, options_.schedule_delay_millis, is_flushed))
+    {
+    }
+  }
+  else
+  {
+    flush_cv_.wait_for(flush_lock, timeout, is_flushed);
+  }
+}
+
+void BatchSpanProcessor::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  if (is_shutdown_.exchange(true))
+  {
+    return;
+  }
+  waiter_->Wake();
+  {
+    std::lock_guard<std::mutex> guard{space_m_};
+  }
+  space_cv_.notify_all();
+
+  for (auto &worker_thread : worker_threads_)
+  {
+    if (worker_thread.joinable())
+    {
+      worker_thread.join();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard{flush_m_};
+    flush_completed_count_ = flush_requested_count_;
+  }
+  flush_cv_.notify_all();
+
+  for (auto &exporter : exporters_)
+  {
+    exporter->Shutdown(timeout);
+  }
+}
+
+void BatchSpanProcessor::DoBackgroundWork(size_t worker_index) noexcept
+{
+  while (true)
+  {
+    std::unique_lock<std::mutex> leader_lock{leader_m_};
+    if (!is_shutdown_)
+    {
+      waiter_->WaitUntil(options_.max_export_batch_size,
+                         std::chrono::steady_clock::now() + options_.schedule_delay_millis,
+                         [this] { return GetQueueSize(); });
+    }
+
+    if (is_shutdown_)
+    {
+      DrainQueue(worker_index);
+      WaitForBusyWorkers();
+      return;
+    }
+
+    if (is_force_flush_.exchange(false))
+    {
+      uint64_t flush_count;
+      {
+        std::lock_guard<std::mutex> guard{flush_m_};
+        flush_count = flush_requested_count_;
+      }
+      DrainQueue(worker_index);
+      WaitForBusyWorkers();
+      {
+        std::lock_guard<std::mutex> guard{flush_m_};
+        flush_completed_count_ = flush_count;
+      }
+      flush_cv_.notify_all();
+      continue;
+    }
+
+    // Only export what was buffered when the worker woke up, so that a steady
+    // stream of new spans can't keep the worker from re-checking its flags.
+    auto num_spans = GetQueueSize();
+
+    // Let another worker wait for spans while this one exports.
+    {
+      std::lock_guard<std::mutex> guard{busy_m_};
+      ++num_busy_workers_;
+    }
+    leader_lock.unlock();
+
+    while (num_spans > 0)
+    {
+      auto num_exported =
+          ExportBatch(worker_index, std::min(num_spans, options_.max_export_batch_size));
+      if (num_exported == 0)
+      {
+        break;
+      }
+      num_spans -= num_exported;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard{busy_m_};
+      --num_busy_workers_;
+    }
+    busy_cv_.notify_all();
+  }
+}
+
+void BatchSpanProcessor::WaitForBusyWorkers() noexcept
+{
+  std::unique_lock<std::mutex> lock{busy_m_};
+  while (num_busy_workers_ > 0)
+  {
+    busy_cv_.wait_for(lock, options_.schedule_delay_millis);
+  }
+}
+
+size_t BatchSpanProcessor::ExportBatch(size_t worker_index, size_t max_spans) noexcept
+{
+  auto &batch     = batches_[worker_index];
+  auto take_spans = [&batch](CircularBufferRange<AtomicUniquePtr<Recordable>> range) noexcept {
+    range.ForEach([&batch](AtomicUniquePtr<Recordable> &ptr) {
+      std::unique_ptr<Recordable> span;
+      ptr.Swap(span);
+      batch.push_back(std::move(span));
+      return true;
+    });
+  };
+
+  size_t num_spans = buffer_->ConsumeConcurrently(max_spans, take_spans);
+  if (num_spans == 0)
+  {
+    return 0;
+  }
+
+  // Room was made in the queue, so producers blocked on it can retry.
+  if (num_blocked_producers_ > 0)
+  {
+    {
+      std::lock_guard<std::mutex> guard{space_m_};
+    }
+    space_cv_.notify_all();
+  }
+
+  if (exporters_[worker_index]->Export(
+          nostd::span<std::unique_ptr<Recordable>>(batch.data(), batch.size())) ==
+      ExportResult::kFailure)
+  {
+    /* Once it is defined how the SDK does logging, an error should be
+     * logged in this case. */
+  }
+  batch.clear();
+  return num_spans;
+}
+
+size_t BatchSpanProcessor::GetQueueSize() const noexcept
+{
+  return buffer_->size();
+}
+
+void BatchSpanProcessor::DrainQueue(size_t worker_index) noexcept
+{
+  while (ExportBatch(worker_index, options_.max_export_batch_size) > 0)
+  {
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,36 @@
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
+
+#include <mutex>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+const InstrumentationLibrary &InstrumentationLibrary::Get(nostd::string_view name,
+                                                          nostd::string_view version)
+{
+  // Libraries are looked up when tracers are created, not per span, and
+  // processes use few of them, so a linear search under a mutex suffices.
+  // Both are leaked, so that libraries outlive spans ended during static
+  // destruction.
+  static auto mutex     = new std::mutex;
+  static auto libraries = new std::vector<const InstrumentationLibrary *>;
+
+  std::lock_guard<std::mutex> guard{*mutex};
+  for (auto library : *libraries)
+  {
+    if (library->name_ == name && library->version_ == version)
+    {
+      return *library;
+    }
+  }
+  // Make room first, so that the new library isn't leaked if that fails.
+  libraries->reserve(libraries->size() + 1);
+  libraries->push_back(new InstrumentationLibrary{name, version});
+  return *libraries->back();
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,82 @@
+#include "opentelemetry/sdk/trace/random_id_generator.h"
+
+#include "src/common/platform/fork.h"
+#include "src/common/random.h"
+
+#include <cstdint>
+#include <cstring>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+const size_t kPoolSize = 64;
+
+struct IdPool
+{
+  uint64_t ids[kPoolSize];
+  size_t next = kPoolSize;
+};
+
+thread_local IdPool id_pool;
+
+// Only the forking thread exists in the child, so emptying its pool is
+// enough to make the child draw fresh numbers from the reseeded generator.
+void OnFork() noexcept
+{
+  id_pool.next = kPoolSize;
+}
+
+uint64_t NextId() noexcept
+{
+  auto &pool = id_pool;
+  if (pool.next == kPoolSize)
+  {
+    for (auto &id : pool.ids)
+    {
+      id = sdk::common::Random::GenerateRandom64();
+    }
+    pool.next = 0;
+  }
+  return pool.ids[pool.next++];
+}
+
+// All-zero ids are invalid, so draw another number in the unlikely case of 0.
+uint64_t NextNonZeroId() noexcept
+{
+  uint64_t id;
+  do
+  {
+    id = NextId();
+  } while (id == 0);
+  return id;
+}
+}  // namespace
+
+RandomIdGenerator::RandomIdGenerator() noexcept
+{
+  static const int fork_handler = sdk::common::platform::AtFork(nullptr, nullptr, OnFork);
+  (void)fork_handler;
+}
+
+trace_api::TraceId RandomIdGenerator::GenerateTraceId() noexcept
+{
+  uint64_t ids[2] = {NextId(), NextNonZeroId()};
+  uint8_t buffer[trace_api::TraceId::kSize];
+  std::memcpy(buffer, ids, sizeof(buffer));
+  return trace_api::TraceId{buffer};
+}
+
+trace_api::SpanId RandomIdGenerator::GenerateSpanId() noexcept
+{
+  uint64_t id = NextNonZeroId();
+  uint8_t buffer[trace_api::SpanId::kSize];
+  std::memcpy(buffer, &id, sizeof(buffer));
+  return trace_api::SpanId{buffer};
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
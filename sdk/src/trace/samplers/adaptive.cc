@@ -0,0 +1,117 @@
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "opentelemetry/sdk/common/thread_number.h"
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+std::string MakeDescription(double target_spans_per_second)
+{
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "AdaptiveSampler{%f}", target_spans_per_second);
+  return buffer;
+}
+}  // namespace
+
+AdaptiveSampler::AdaptiveSampler(const AdaptiveSamplerOptions &options)
+    : options_(options),
+      description_{MakeDescription(options.target_spans_per_second)},
+      threshold_{TraceIdRatioBasedSampler::RatioToThreshold(options.initial_ratio)},
+      ratio_{options.initial_ratio > 0.0 ? std::min(options.initial_ratio, 1.0) : 0.0}
+{
+  if (!(options_.smoothing > 0.0 && options_.smoothing <= 1.0))
+  {
+    options_.smoothing = 1.0;
+  }
+  if (options_.adjustment_interval > std::chrono::milliseconds::zero())
+  {
+    worker_thread_ = std::thread{&AdaptiveSampler::DoBackgroundWork, this};
+  }
+}
+
+AdaptiveSampler::~AdaptiveSampler()
+{
+  {
+    std::lock_guard<std::mutex> guard{shutdown_m_};
+    is_shutdown_ = true;
+  }
+  shutdown_cv_.notify_one();
+  if (worker_thread_.joinable())
+  {
+    worker_thread_.join();
+  }
+}
+
+SamplingResult AdaptiveSampler::ShouldSample(
+    const trace_api::SpanContext * /*parent_context*/,
+    trace_api::TraceId trace_id,
+    nostd::string_view /*name*/,
+    trace_api::SpanKind /*span_kind*/,
+    const trace_api::KeyValueIterable & /*attributes*/) noexcept
+{
+  counters_[common::GetThreadNumber() % kNumCounterSlots].count.fetch_add(
+      1, std::memory_order_relaxed);
+  if (TraceIdRatioBasedSampler::IsSampled(trace_id, threshold_.load(std::memory_order_relaxed)))
+  {
+    return {Decision::RECORD_AND_SAMPLE, nullptr};
+  }
+  return {Decision::NOT_RECORD, nullptr};
+}
+
+void AdaptiveSampler::AdjustRatio(std::chrono::nanoseconds elapsed) noexcept
+{
+  if (elapsed <= std::chrono::nanoseconds::zero())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> guard{adjust_m_};
+  uint64_t count = 0;
+  for (auto &counter : counters_)
+  {
+    count += counter.count.load(std::memory_order_relaxed);
+  }
+  auto rate   = (count - last_count_) / std::chrono::duration<double>(elapsed).count();
+  last_count_ = count;
+
+  smoothed_rate_ = smoothed_rate_ < 0.0
+                       ? rate
+                       : options_.smoothing * rate + (1.0 - options_.smoothing) * smoothed_rate_;
+  // Without spans, sample everything, so that the first spans after a quiet
+  // period aren't lost.
+  auto ratio = smoothed_rate_ > 0.0
+                   ? std::min(1.0, options_.target_spans_per_second / smoothed_rate_)
+                   : 1.0;
+  threshold_.store(TraceIdRatioBasedSampler::RatioToThreshold(ratio), std::memory_order_relaxed);
+  ratio_.store(std::max(ratio, 0.0), std::memory_order_relaxed);
+}
+
+double AdaptiveSampler::GetRatio() const noexcept
+{
+  return ratio_.load(std::memory_order_relaxed);
+}
+
+void AdaptiveSampler::DoBackgroundWork() noexcept
+{
+  auto last_time = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock{shutdown_m_};
+  while (
+      !shutdown_cv_.wait_for(lock, options_.adjustment_interval, [this] { return is_shutdown_; }))
+  {
+    lock.unlock();
+    auto now = std::chrono::steady_clock::now();
+    AdjustRatio(now - last_time);
+    last_time = now;
+    lock.lock();
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,84 @@
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+const int64_t kNanosPerSecond = 1000000000;
+const int64_t kMaxInterval    = INT64_MAX / 4;
+
+std::string MakeDescription(double spans_per_second)
+{
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "RateLimitingSampler{%f}", spans_per_second);
+  return buffer;
+}
+
+int64_t GetSteadyNanos() noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+RateLimitingSampler::RateLimitingSampler(double spans_per_second) noexcept
+{
+  // Also catches NaN.
+  if (!(spans_per_second > 0.0))
+  {
+    spans_per_second = 0.0;
+  }
+  if (spans_per_second == 0.0)
+  {
+    interval_ = 0;
+  }
+  else
+  {
+    // Clamped to at least a nanosecond, and small enough that adding it to a
+    // timestamp can't overflow.
+    auto interval = std::min(kNanosPerSecond / spans_per_second, static_cast<double>(kMaxInterval));
+    interval_     = std::max<int64_t>(1, std::llround(interval));
+  }
+  // The bucket holds one second's worth of spans, but at least one span.
+  max_debt_    = std::max(kNanosPerSecond, interval_);
+  description_ = MakeDescription(spans_per_second);
+}
+
+SamplingResult RateLimitingSampler::ShouldSample(
+    const trace_api::SpanContext * /*parent_context*/,
+    trace_api::TraceId /*trace_id*/,
+    nostd::string_view /*name*/,
+    trace_api::SpanKind /*span_kind*/,
+    const trace_api::KeyValueIterable & /*attributes*/) noexcept
+{
+  if (interval_ == 0)
+  {
+    return {Decision::NOT_RECORD, nullptr};
+  }
+  auto now       = GetSteadyNanos();
+  auto full_time = full_time_.load(std::memory_order_relaxed);
+  while (true)
+  {
+    auto new_full_time = std::max(full_time, now) + interval_;
+    if (new_full_time - now > max_debt_)
+    {
+      return {Decision::NOT_RECORD, nullptr};
+    }
+    if (full_time_.compare_exchange_weak(full_time, new_full_time, std::memory_order_relaxed))
+    {
+      return {Decision::RECORD_AND_SAMPLE, nullptr};
+    }
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
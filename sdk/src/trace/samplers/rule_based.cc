@@ -0,0 +1,200 @@
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
+
+#include <algorithm>
+#include <map>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/**
+ * Compares an attribute value with a value of the same alternative.
+ */
+struct AttributeValueEquals
+{
+  const opentelemetry::common::AttributeValue &other;
+
+  template <class T>
+  bool operator()(const T &value) const noexcept
+  {
+    return nostd::get<T>(other) == value;
+  }
+
+  template <class T>
+  bool operator()(const nostd::span<const T> &values) const noexcept
+  {
+    auto other_values = nostd::get<nostd::span<const T>>(other);
+    return values.size() == other_values.size() &&
+           std::equal(values.begin(), values.end(), other_values.begin());
+  }
+};
+
+bool Equals(const opentelemetry::common::AttributeValue &lhs,
+            const opentelemetry::common::AttributeValue &rhs) noexcept
+{
+  return lhs.index() == rhs.index() && nostd::visit(AttributeValueEquals{rhs}, lhs);
+}
+
+/**
+ * @return whether a span was started with an attribute of the given key and
+ * value.
+ */
+bool HasAttribute(const trace_api::KeyValueIterable &attributes,
+                  const std::string &key,
+                  const opentelemetry::common::AttributeValue &value) noexcept
+{
+  bool is_found = false;
+  attributes.ForEachKeyValue(
+      [&](nostd::string_view span_key, opentelemetry::common::AttributeValue span_value) noexcept {
+        is_found = span_key == key && Equals(span_value, value);
+        return !is_found;
+      });
+  return is_found;
+}
+
+/**
+ * A node of the trie while it's built.
+ */
+struct BuildNode
+{
+  std::map<char, size_t> children;
+  std::vector<uint32_t> prefix_rules;
+  std::vector<uint32_t> exact_rules;
+};
+}  // namespace
+
+RuleBasedSampler::RuleBasedSampler(std::vector<SamplingRule> rules,
+                                   std::shared_ptr<Sampler> default_sampler)
+    : rules_{std::move(rules)}, default_sampler_{std::move(default_sampler)}
+{
+  std::vector<BuildNode> build_nodes(1);
+  for (uint32_t i = 0; i < rules_.size(); ++i)
+  {
+    size_t node = 0;
+    for (char c : rules_[i].name)
+    {
+      auto child = build_nodes[node].children.find(c);
+      if (child == build_nodes[node].children.end())
+      {
+        build_nodes[node].children[c] = build_nodes.size();
+        node                          = build_nodes.size();
+        build_nodes.emplace_back();
+      }
+      else
+      {
+        node = child->second;
+      }
+    }
+    (rules_[i].is_prefix ? build_nodes[node].prefix_rules : build_nodes[node].exact_rules)
+        .push_back(i);
+  }
+
+  // Flatten the trie into contiguous arrays. Node indices are kept, and rule
+  // indices stay in ascending order within every node.
+  nodes_.reserve(build_nodes.size());
+  for (auto &build_node : build_nodes)
+  {
+    Node node;
+    node.first_edge = static_cast<uint32_t>(edges_.size());
+    node.num_edges  = static_cast<uint32_t>(build_node.children.size());
+    for (auto &child : build_node.children)
+    {
+      edges_.push_back(Edge{child.first, static_cast<uint32_t>(child.second)});
+    }
+    node.first_prefix_rule = static_cast<uint32_t>(rule_indices_.size());
+    node.num_prefix_rules  = static_cast<uint32_t>(build_node.prefix_rules.size());
+    rule_indices_.insert(rule_indices_.end(), build_node.prefix_rules.begin(),
+                         build_node.prefix_rules.end());
+    node.first_exact_rule = static_cast<uint32_t>(rule_indices_.size());
+    node.num_exact_rules  = static_cast<uint32_t>(build_node.exact_rules.size());
+    rule_indices_.insert(rule_indices_.end(), build_node.exact_rules.begin(),
+                         build_node.exact_rules.end());
+    nodes_.push_back(node);
+  }
+}
+
+SamplingResult RuleBasedSampler::ShouldSample(
+    const trace_api::SpanContext *parent_context,
+    trace_api::TraceId trace_id,
+    nostd::string_view name,
+    trace_api::SpanKind span_kind,
+    const trace_api::KeyValueIterable &attributes) noexcept
+{
+  // Rules with a matching name prefix are found along the path of the name,
+  // and rules with a matching exact name at its end.
+  auto num_rules   = static_cast<uint32_t>(rules_.size());
+  const Node *node = &nodes_.front();
+  auto best_rule   = FindFirstMatch(node->first_prefix_rule, node->num_prefix_rules, num_rules,
+                                  span_kind, attributes);
+  for (char c : name)
+  {
+    auto edges_begin = edges_.data() + node->first_edge;
+    auto edges_end   = edges_begin + node->num_edges;
+    auto edge        = std::lower_bound(edges_begin, edges_end, c,
+                                 [](const Edge &e, char value) { return e.character < value; });
+    if (edge == edges_end || edge->character != c)
+    {
+      node = nullptr;
+      break;
+    }
+    node      = &nodes_[edge->node];
+    best_rule = FindFirstMatch(node->first_prefix_rule, node->num_prefix_rules, best_rule,
+                               span_kind, attributes);
+  }
+  if (node != nullptr)
+  {
+    best_rule = FindFirstMatch(node->first_exact_rule, node->num_exact_rules, best_rule, span_kind,
+                               attributes);
+  }
+
+  auto &sampler = best_rule < num_rules ? rules_[best_rule].sampler : default_sampler_;
+  return sampler->ShouldSample(parent_context, trace_id, name, span_kind, attributes);
+}
+
+std::string RuleBasedSampler::GetDescription() const noexcept
+{
+  return "RuleBasedSampler{" + std::to_string(rules_.size()) +
+         " rules, default=" + default_sampler_->GetDescription() + "}";
+}
+
+uint32_t RuleBasedSampler::FindFirstMatch(uint32_t first,
+                                          uint32_t count,
+                                          uint32_t best_rule,
+                                          trace_api::SpanKind span_kind,
+                                          const trace_api::KeyValueIterable &attributes) const
+    noexcept
+{
+  for (uint32_t i = first; i < first + count; ++i)
+  {
+    auto rule_index = rule_indices_[i];
+    if (rule_index >= best_rule)
+    {
+      break;
+    }
+    auto &rule = rules_[rule_index];
+    if (rule.match_span_kind && rule.span_kind != span_kind)
+    {
+      continue;
+    }
+    bool has_attributes = true;
+    for (auto &attribute : rule.attributes)
+    {
+      if (!HasAttribute(attributes, attribute.first, attribute.second.Get()))
+      {
+        has_attributes = false;
+        break;
+      }
+    }
+    if (has_attributes)
+    {
+      return rule_index;
+    }
+  }
+  return best_rule;
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,79 @@
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+
+#include <cmath>
+#include <cstdio>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+std::string MakeDescription(double ratio)
+{
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "TraceIdRatioBasedSampler{%f}", ratio);
+  return buffer;
+}
+
+/**
+ * @return the last 8 bytes of trace_id as a big-endian integer.
+ */
+uint64_t GetLowBits(const trace_api::TraceId &trace_id) noexcept
+{
+  auto id       = trace_id.Id();
+  uint64_t bits = 0;
+  for (int i = trace_api::TraceId::kSize - 8; i < trace_api::TraceId::kSize; ++i)
+  {
+    bits = (bits << 8) | id[i];
+  }
+  return bits;
+}
+
+/**
+ * @return ratio clamped to [0, 1], with NaN treated as 0.
+ */
+double ClampRatio(double ratio) noexcept
+{
+  if (!(ratio > 0.0))
+  {
+    return 0.0;
+  }
+  return ratio > 1.0 ? 1.0 : ratio;
+}
+}  // namespace
+
+TraceIdRatioBasedSampler::TraceIdRatioBasedSampler(double ratio) noexcept
+    : threshold_{RatioToThreshold(ratio)}, description_{MakeDescription(ClampRatio(ratio))}
+{}
+
+uint64_t TraceIdRatioBasedSampler::RatioToThreshold(double ratio) noexcept
+{
+  ratio = ClampRatio(ratio);
+  // ratio * 2^64, which fits a uint64_t for any ratio below 1.
+  return ratio == 1.0 ? UINT64_MAX : static_cast<uint64_t>(std::ldexp(ratio, 64));
+}
+
+bool TraceIdRatioBasedSampler::IsSampled(const trace_api::TraceId &trace_id,
+                                         uint64_t threshold) noexcept
+{
+  return threshold == UINT64_MAX || GetLowBits(trace_id) < threshold;
+}
+
+SamplingResult TraceIdRatioBasedSampler::ShouldSample(
+    const trace_api::SpanContext * /*parent_context*/,
+    trace_api::TraceId trace_id,
+    nostd::string_view /*name*/,
+    trace_api::SpanKind /*span_kind*/,
+    const trace_api::KeyValueIterable & /*attributes*/) noexcept
+{
+  if (IsSampled(trace_id, threshold_))
+  {
+    return {Decision::RECORD_AND_SAMPLE, nullptr};
+  }
+  return {Decision::NOT_RECORD, nullptr};
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,5 +1,7 @@
 #include "src/trace/span.h"
 
+#include <thread>
+
 #include "opentelemetry/version.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -36,45 +38,205 @@ SteadyTimestamp NowOr(const SteadyTimestamp &steady)
     return steady;
   }
 }
+
+// The maximum number of idle memory blocks of one size cached by a thread.
+const size_t kMaxCachedBlocks = 64;
+
+/**
+ * The idle memory blocks of one size cached by a thread, linked through their
+ * first bytes. It's trivially destructible, so that objects deleted while the
+ * thread exits can still check whether it's disabled.
+ */
+struct FreeList
+{
+  void *head;
+  size_t size;
+  bool is_disabled;
+};
+
+/**
+ * Frees the blocks cached by a thread when it exits.
+ */
+struct FreeListReleaser
+{
+  FreeList &free_list;
+
+  ~FreeListReleaser()
+  {
+    free_list.is_disabled = true;
+    while (free_list.head != nullptr)
+    {
+      auto block     = free_list.head;
+      free_list.head = *static_cast<void **>(block);
+      ::operator delete(block);
+    }
+    free_list.size = 0;
+  }
+};
+
+void *AllocateBlock(FreeList &free_list, size_t size) noexcept
+{
+  if (free_list.head == nullptr)
+  {
+    return ::operator new(size, std::nothrow);
+  }
+  auto block     = free_list.head;
+  free_list.head = *static_cast<void **>(block);
+  --free_list.size;
+  return block;
+}
+
+void FreeBlock(FreeList &free_list, FreeListReleaser &releaser, void *block) noexcept
+{
+  if (free_list.is_disabled || free_list.size == kMaxCachedBlocks)
+  {
+    ::operator delete(block);
+    return;
+  }
+
+  // Make sure the cached blocks are freed when the thread exits.
+  (void)&releaser;
+
+  *static_cast<void **>(block) = free_list.head;
+  free_list.head               = block;
+  ++free_list.size;
+}
+
+thread_local FreeList span_free_list;
+thread_local FreeListReleaser span_free_list_releaser{span_free_list};
+
+thread_local FreeList deferred_data_free_list;
+thread_local FreeListReleaser deferred_data_free_list_releaser{deferred_data_free_list};
 }  // namespace
 
+void *Span::operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  return AllocateBlock(span_free_list, size);
+}
+
+void Span::operator delete(void *span) noexcept
+{
+  FreeBlock(span_free_list, span_free_list_releaser, span);
+}
+
+void Span::operator delete(void *span, const std::nothrow_t &) noexcept
+{
+  Span::operator delete(span);
+}
+
+void *Span::DeferredData::operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  return AllocateBlock(deferred_data_free_list, size);
+}
+
+void Span::DeferredData::operator delete(void *data) noexcept
+{
+  FreeBlock(deferred_data_free_list, deferred_data_free_list_releaser, data);
+}
+
+void Span::DeferredData::operator delete(void *data, const std::nothrow_t &) noexcept
+{
+  DeferredData::operator delete(data);
+}
+
 Span::Span(std::shared_ptr<Tracer> &&tracer,
-           std::shared_ptr<SpanProcessor> processor,
+           std::shared_ptr<SpanProcessor> &&processor,
            nostd::string_view name,
            const trace_api::KeyValueIterable &attributes,
-           const trace_api::StartSpanOptions &options) noexcept
-    : tracer_{std::move(tracer)},
-      processor_{processor},
+           const trace_api::StartSpanOptions &options,
+           const trace_api::TraceId &trace_id,
+           const FlatAttributeMap *sampling_attributes) noexcept
+    : is_single_owner_{tracer->GetSpanSynchronization() == SpanSynchronization::kSingleOwner},
+      tracer_{std::move(tracer)},
+      processor_{std::move(processor)},
       recordable_{processor_->MakeRecordable()},
       start_steady_time{options.start_steady_time}
 {
-  (void)options;
   if (recordable_ == nullptr)
   {
+    state_.store(kEnded, std::memory_order_relaxed);
     return;
   }
   processor_->OnStart(*recordable_);
   recordable_->SetName(name);
+  recordable_->SetInstrumentationLibrary(
+      static_cast<Tracer &>(*tracer_).GetInstrumentationLibrary());
 
-  attributes.ForEachKeyValue([&](nostd::string_view key, common::AttributeValue value) noexcept {
-    recordable_->SetAttribute(key, std::move(value));
-    return true;
-  });
+  // Spans don't have parents yet, so every span is the root of its trace.
+  recordable_->SetIds(trace_id,
+                      static_cast<Tracer &>(*tracer_).GetIdGenerator().GenerateSpanId(),
+                      trace_api::SpanId{});
+
+  attributes.ForEachKeyValue(
+      [&](nostd::string_view key, opentelemetry::common::AttributeValue value) noexcept {
+        recordable_->SetAttribute(key, std::move(value));
+        return true;
+      });
+  if (sampling_attributes != nullptr)
+  {
+    for (auto &entry : *sampling_attributes)
+    {
+      recordable_->SetAttribute(entry.GetKey(), entry.value.Get());
+    }
+  }
 
   recordable_->SetStartTime(NowOr(options.start_system_time));
   start_steady_time = NowOr(options.start_steady_time);
 }
 
+Span::Span(std::shared_ptr<Tracer> &&tracer) noexcept
+    : state_{kEnded}, is_single_owner_{true}, tracer_{std::move(tracer)}
+{}
+
+Span::Span(std::shared_ptr<Tracer> &&tracer,
+           nostd::string_view name,
+           const trace_api::KeyValueIterable &attributes,
+           const trace_api::StartSpanOptions &options,
+           const trace_api::TraceId &trace_id) noexcept
+    : is_single_owner_{tracer->GetSpanSynchronization() == SpanSynchronization::kSingleOwner},
+      tracer_{std::move(tracer)},
+      start_steady_time{NowOr(options.start_steady_time)},
+      deferred_{new (std::nothrow) DeferredData}
+{
+  if (deferred_ == nullptr)
+  {
+    state_.store(kEnded, std::memory_order_relaxed);
+    return;
+  }
+  auto &id_generator           = static_cast<Tracer &>(*tracer_).GetIdGenerator();
+  deferred_->trace_id          = trace_id;
+  deferred_->span_id           = id_generator.GenerateSpanId();
+  deferred_->start_system_time = NowOr(options.start_system_time);
+  deferred_->name              = opentelemetry::common::AttributeValue{name};
+
+  attributes.ForEachKeyValue(
+      [&](nostd::string_view key, opentelemetry::common::AttributeValue value) noexcept {
+        deferred_->SetAttribute(key, value);
+        return true;
+      });
+}
+
 Span::~Span()
 {
   End();
 }
 
-void Span::SetAttribute(nostd::string_view key, const common::AttributeValue &&value) noexcept
+void Span::SetAttribute(nostd::string_view key,
+                        const opentelemetry::common::AttributeValue &&value) noexcept
 {
-  std::lock_guard<std::mutex> lock_guard{mu_};
-
-  recordable_->SetAttribute(key, std::move(value));
+  if (!Lock())
+  {
+    return;
+  }
+  if (deferred_ != nullptr)
+  {
+    deferred_->SetAttribute(key, value);
+  }
+  else
+  {
+    recordable_->SetAttribute(key, std::move(value));
+  }
+  Unlock();
 }
 
 void Span::AddEvent(nostd::string_view name) noexcept
@@ -99,44 +261,161 @@ void Span::AddEvent(nostd::string_view name,
 
 void Span::SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept
 {
-  std::lock_guard<std::mutex> lock_guard{mu_};
-  if (recordable_ == nullptr)
+  if (!Lock())
   {
     return;
   }
-  recordable_->SetStatus(code, description);
+  if (deferred_ != nullptr)
+  {
+    deferred_->has_status         = true;
+    deferred_->status_code        = code;
+    deferred_->status_description = opentelemetry::common::AttributeValue{description};
+  }
+  else
+  {
+    recordable_->SetStatus(code, description);
+  }
+  Unlock();
 }
 
 void Span::UpdateName(nostd::string_view name) noexcept
 {
-  std::lock_guard<std::mutex> lock_guard{mu_};
-  if (recordable_ == nullptr)
+  if (!Lock())
   {
     return;
   }
-  recordable_->SetName(name);
+  if (deferred_ != nullptr)
+  {
+    deferred_->name = opentelemetry::common::AttributeValue{name};
+  }
+  else
+  {
+    recordable_->SetName(name);
+  }
+  Unlock();
 }
 
 void Span::End(const trace_api::EndSpanOptions &options) noexcept
 {
-  std::lock_guard<std::mutex> lock_guard{mu_};
-  if (recordable_ == nullptr)
+  if (!Lock())
   {
     return;
   }
 
   auto end_steady_time = NowOr(options.end_steady_time);
-  recordable_->SetDuration(std::chrono::steady_clock::time_point(end_steady_time) -
-                           std::chrono::steady_clock::time_point(start_steady_time));
+  std::chrono::nanoseconds duration =
+      std::chrono::steady_clock::time_point(end_steady_time) -
+      std::chrono::steady_clock::time_point(start_steady_time);
+  if (deferred_ != nullptr)
+  {
+    // Once the span is ended, no other thread accesses deferred_.
+    Unlock(kEnded);
+    RecordDeferred(duration);
+    delete deferred_;
+    deferred_ = nullptr;
+    return;
+  }
+  recordable_->SetDuration(duration);
+  auto recordable = std::move(recordable_);
+  Unlock(kEnded);
+
+  // The processor is called without holding the lock, so that other threads
+  // don't spin while the span is being exported.
+  processor_->OnEnd(std::move(recordable));
+}
+
+void Span::RecordDeferred(std::chrono::nanoseconds duration) noexcept
+{
+  auto &tracer = static_cast<Tracer &>(*tracer_);
+  if (!tracer.GetDeferredSamplingPredicate()(duration, deferred_->status_code))
+  {
+    return;
+  }
+  auto processor  = tracer.GetProcessor();
+  auto recordable = processor->MakeRecordable();
+  if (recordable == nullptr)
+  {
+    return;
+  }
+  processor->OnStart(*recordable);
+  recordable->SetName(nostd::get<nostd::string_view>(deferred_->name.Get()));
+  recordable->SetInstrumentationLibrary(tracer.GetInstrumentationLibrary());
+  recordable->SetIds(deferred_->trace_id, deferred_->span_id, trace_api::SpanId{});
+  for (size_t i = 0; i < deferred_->num_attributes; ++i)
+  {
+    auto &attribute = deferred_->attributes[i];
+    recordable->SetAttribute(attribute.GetKey(), attribute.value.Get());
+  }
+  if (deferred_->has_status)
+  {
+    recordable->SetStatus(deferred_->status_code,
+                          nostd::get<nostd::string_view>(deferred_->status_description.Get()));
+  }
+  recordable->SetStartTime(deferred_->start_system_time);
+  recordable->SetDuration(duration);
+  processor->OnEnd(std::move(recordable));
+}
 
-  processor_->OnEnd(std::move(recordable_));
-  recordable_.reset();
+void Span::DeferredData::SetAttribute(nostd::string_view key,
+                                      const opentelemetry::common::AttributeValue &value) noexcept
+{
+  auto key_id = AttributeKeyTable::GetGlobal().Intern(key);
+  if (key_id == AttributeKeyTable::kInvalidKeyId)
+  {
+    return;
+  }
+  for (size_t i = 0; i < num_attributes; ++i)
+  {
+    if (attributes[i].key_id == key_id)
+    {
+      attributes[i].value = value;
+      return;
+    }
+  }
+  if (num_attributes == kMaxDeferredAttributes)
+  {
+    return;
+  }
+  attributes[num_attributes].key_id = key_id;
+  attributes[num_attributes].value  = value;
+  ++num_attributes;
 }
 
 bool Span::IsRecording() const noexcept
 {
-  std::lock_guard<std::mutex> lock_guard{mu_};
-  return recordable_ != nullptr;
+  return state_.load(std::memory_order_acquire) != kEnded;
+}
+
+bool Span::Lock() noexcept
+{
+  if (is_single_owner_)
+  {
+    return state_.load(std::memory_order_relaxed) != kEnded;
+  }
+  uint8_t state = kRecording;
+  while (!state_.compare_exchange_weak(state, kLocked, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+  {
+    if (state == kEnded)
+    {
+      return false;
+    }
+    if (state == kLocked)
+    {
+      std::this_thread::yield();
+    }
+    state = kRecording;
+  }
+  return true;
+}
+
+void Span::Unlock(uint8_t state) noexcept
+{
+  if (is_single_owner_ && state == kRecording)
+  {
+    return;
+  }
+  state_.store(state, std::memory_order_release);
 }
 }  // namespace trace
 }  // namespace sdk
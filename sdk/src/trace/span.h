@@ -1,8 +1,14 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
+#include "opentelemetry/sdk/common/owned_attribute_value.h"
+#include "opentelemetry/sdk/trace/flat_attribute_map.h"
 #include "opentelemetry/sdk/trace/tracer.h"
+#include "opentelemetry/trace/trace_id.h"
 #include "opentelemetry/version.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -15,16 +21,52 @@ namespace trace_api = opentelemetry::trace;
 class Span final : public trace_api::Span
 {
 public:
+  /**
+   * Start a recording span.
+   * @param trace_id the id of the span's trace
+   * @param sampling_attributes attributes added by the sampler, or nullptr
+   */
   explicit Span(std::shared_ptr<Tracer> &&tracer,
-                std::shared_ptr<SpanProcessor> processor,
+                std::shared_ptr<SpanProcessor> &&processor,
                 nostd::string_view name,
                 const trace_api::KeyValueIterable &attributes,
-                const trace_api::StartSpanOptions &options) noexcept;
+                const trace_api::StartSpanOptions &options,
+                const trace_api::TraceId &trace_id,
+                const FlatAttributeMap *sampling_attributes) noexcept;
+
+  /**
+   * Start a span that the sampler decided not to record. It has no
+   * recordable and never calls a processor.
+   */
+  explicit Span(std::shared_ptr<Tracer> &&tracer) noexcept;
+
+  /**
+   * Start a deferred span, which the sampler decided not to record. It keeps
+   * its data in a block from a per-thread cache, and only makes a recordable
+   * when it ends, if the tracer's deferred sampling predicate keeps it.
+   * @param trace_id the id of the span's trace
+   */
+  explicit Span(std::shared_ptr<Tracer> &&tracer,
+                nostd::string_view name,
+                const trace_api::KeyValueIterable &attributes,
+                const trace_api::StartSpanOptions &options,
+                const trace_api::TraceId &trace_id) noexcept;
 
   ~Span() override;
 
+  /**
+   * Spans are allocated from a per-thread cache of memory blocks, so that
+   * starting a span usually doesn't take a heap allocation.
+   */
+  static void *operator new(size_t size, const std::nothrow_t &) noexcept;
+
+  static void operator delete(void *span) noexcept;
+
+  static void operator delete(void *span, const std::nothrow_t &) noexcept;
+
   // trace_api::Span
-  void SetAttribute(nostd::string_view key, const common::AttributeValue &&value) noexcept override;
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &&value) noexcept override;
 
   void AddEvent(nostd::string_view name) noexcept override;
 
@@ -45,11 +87,83 @@ class Span final : public trace_api::Span
   trace_api::Tracer &tracer() const noexcept override { return *tracer_; }
 
 private:
+  /**
+   * The maximum number of attributes a deferred span keeps. Further
+   * attributes are dropped.
+   */
+  static const size_t kMaxDeferredAttributes = 4;
+
+  /**
+   * The data of a deferred span, which is only copied into a recordable if
+   * the span is kept when it ends. Strings of up to
+   * OwnedAttributeValue::kInlineSize bytes are stored inline.
+   */
+  struct DeferredData
+  {
+    trace_api::TraceId trace_id;
+    trace_api::SpanId span_id;
+    opentelemetry::core::SystemTimestamp start_system_time;
+    sdk::common::OwnedAttributeValue name;
+    bool has_status                      = false;
+    trace_api::CanonicalCode status_code = trace_api::CanonicalCode::OK;
+    sdk::common::OwnedAttributeValue status_description;
+    FlatAttributeMap::Entry attributes[kMaxDeferredAttributes];
+    size_t num_attributes = 0;
+
+    /**
+     * Set an attribute, unless all slots are taken by other keys.
+     */
+    void SetAttribute(nostd::string_view key,
+                      const opentelemetry::common::AttributeValue &value) noexcept;
+
+    /**
+     * Like spans, the data of deferred spans is allocated from a per-thread
+     * cache of memory blocks.
+     */
+    static void *operator new(size_t size, const std::nothrow_t &) noexcept;
+
+    static void operator delete(void *data) noexcept;
+
+    static void operator delete(void *data, const std::nothrow_t &) noexcept;
+  };
+
+  /**
+   * Make a recordable from the data of a deferred span and pass it to the
+   * processor.
+   * @param duration the duration of the span
+   */
+  void RecordDeferred(std::chrono::nanoseconds duration) noexcept;
+
+  // The values of state_.
+  static const uint8_t kRecording = 0;
+  static const uint8_t kLocked    = 1;
+  static const uint8_t kEnded     = 2;
+
+  /**
+   * Take exclusive access to the recordable, unless the span was ended.
+   * @return true if the span is still recording and must be unlocked again
+   */
+  bool Lock() noexcept;
+
+  /**
+   * Give up exclusive access to the recordable.
+   * @param state the state to leave the span in
+   */
+  void Unlock(uint8_t state = kRecording) noexcept;
+
+  // Whether the span is recording, ended, or locked by a thread updating it.
+  // The lock is a spin lock, as it's held only for as long as it takes to
+  // update the recordable. It's never taken for single-owner spans.
+  std::atomic<uint8_t> state_{kRecording};
+  const bool is_single_owner_;
+
   std::shared_ptr<trace_api::Tracer> tracer_;
   std::shared_ptr<SpanProcessor> processor_;
-  mutable std::mutex mu_;
   std::unique_ptr<Recordable> recordable_;
   opentelemetry::core::SteadyTimestamp start_steady_time;
+  // The data of a deferred span until it ends, or nullptr for other spans.
+  // It's kept out of line, so that other spans don't pay for its size.
+  DeferredData *deferred_ = nullptr;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -0,0 +1,143 @@
+#include "opentelemetry/sdk/trace/span_data_pool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+// The number of recordables moved between a thread's cache and the shared
+// list at once. A thread caches at most twice as many.
+const size_t kBatchSize = 32;
+}  // namespace
+
+/**
+ * The shared list of idle recordables. It's kept alive by the threads caching
+ * recordables for it, so that a pool can be destroyed while threads still
+ * hold on to its recordables.
+ */
+class SpanDataPoolStorage
+{
+public:
+  explicit SpanDataPoolStorage(size_t max_size) noexcept : max_size_{max_size} {}
+
+  /**
+   * Move up to kBatchSize recordables into the given cache.
+   */
+  void Take(std::vector<std::unique_ptr<SpanData>> &cache) noexcept
+  {
+    std::lock_guard<std::mutex> guard{mu_};
+    auto n = std::min(kBatchSize, spans_.size());
+    std::move(spans_.end() - n, spans_.end(), std::back_inserter(cache));
+    spans_.resize(spans_.size() - n);
+  }
+
+  /**
+   * Move the last n recordables of the given cache into the shared list.
+   */
+  void Give(std::vector<std::unique_ptr<SpanData>> &cache, size_t n) noexcept
+  {
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      auto num_kept = std::min(n, max_size_ - std::min(max_size_, spans_.size()));
+      std::move(cache.end() - num_kept, cache.end(), std::back_inserter(spans_));
+    }
+    cache.resize(cache.size() - n);
+  }
+
+  size_t size() const noexcept
+  {
+    std::lock_guard<std::mutex> guard{mu_};
+    return spans_.size();
+  }
+
+private:
+  const size_t max_size_;
+  mutable std::mutex mu_;
+  std::vector<std::unique_ptr<SpanData>> spans_;
+};
+
+namespace
+{
+/**
+ * The idle recordables cached by a thread for the pool it used last.
+ */
+struct ThreadCache
+{
+  std::shared_ptr<SpanDataPoolStorage> storage;
+  std::vector<std::unique_ptr<SpanData>> spans;
+
+  ~ThreadCache() { Flush(); }
+
+  void Flush() noexcept
+  {
+    if (storage != nullptr)
+    {
+      storage->Give(spans, spans.size());
+    }
+  }
+};
+
+ThreadCache &GetThreadCache(const std::shared_ptr<SpanDataPoolStorage> &storage) noexcept
+{
+  static thread_local ThreadCache cache;
+  if (cache.storage != storage)
+  {
+    cache.Flush();
+    cache.storage = storage;
+    cache.spans.reserve(2 * kBatchSize + 1);
+  }
+  return cache;
+}
+}  // namespace
+
+SpanDataPool::SpanDataPool(size_t max_size) : storage_{new SpanDataPoolStorage{max_size}} {}
+
+SpanDataPool::~SpanDataPool() = default;
+
+std::unique_ptr<Recordable> SpanDataPool::MakeRecordable() noexcept
+{
+  auto &cache = GetThreadCache(storage_);
+  if (cache.spans.empty())
+  {
+    storage_->Take(cache.spans);
+    if (cache.spans.empty())
+    {
+      return std::unique_ptr<Recordable>(new SpanData);
+    }
+  }
+  std::unique_ptr<Recordable> result = std::move(cache.spans.back());
+  cache.spans.pop_back();
+  return result;
+}
+
+void SpanDataPool::Recycle(std::unique_ptr<Recordable> &&recordable) noexcept
+{
+  if (recordable == nullptr)
+  {
+    return;
+  }
+  std::unique_ptr<SpanData> span{static_cast<SpanData *>(recordable.release())};
+  span->Reset();
+
+  auto &cache = GetThreadCache(storage_);
+  cache.spans.push_back(std::move(span));
+  if (cache.spans.size() > 2 * kBatchSize)
+  {
+    storage_->Give(cache.spans, kBatchSize);
+  }
+}
+
+size_t SpanDataPool::GetSharedSize() const noexcept
+{
+  return storage_->size();
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
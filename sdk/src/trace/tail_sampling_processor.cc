@@ -0,0 +1,341 @@
+#include "opentelemetry/sdk/trace/tail_sampling_processor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/**
+ * Forwards to the recordable of the next processor, and keeps the fields that
+ * the decision is based on.
+ */
+class TailSamplingRecordable final : public Recordable
+{
+public:
+  explicit TailSamplingRecordable(std::unique_ptr<Recordable> &&recordable) noexcept
+      : recordable_{std::move(recordable)}
+  {}
+
+  void SetIds(trace_api::TraceId trace_id,
+              trace_api::SpanId span_id,
+              trace_api::SpanId parent_span_id) noexcept override
+  {
+    trace_id_       = trace_id;
+    parent_span_id_ = parent_span_id;
+    recordable_->SetIds(trace_id, span_id, parent_span_id);
+  }
+
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &&value) noexcept override
+  {
+    recordable_->SetAttribute(key, std::move(value));
+  }
+
+  void AddEvent(nostd::string_view name, core::SystemTimestamp timestamp) noexcept override
+  {
+    recordable_->AddEvent(name, timestamp);
+  }
+
+  void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
+  {
+    status_code_ = code;
+    recordable_->SetStatus(code, description);
+  }
+
+  void SetName(nostd::string_view name) noexcept override { recordable_->SetName(name); }
+
+  void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
+  {
+    recordable_->SetStartTime(start_time);
+  }
+
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override
+  {
+    duration_ = duration;
+    recordable_->SetDuration(duration);
+  }
+
+  void SetInstrumentationLibrary(
+      const InstrumentationLibrary &instrumentation_library) noexcept override
+  {
+    recordable_->SetInstrumentationLibrary(instrumentation_library);
+  }
+
+  std::unique_ptr<Recordable> recordable_;
+  trace_api::TraceId trace_id_;
+  trace_api::SpanId parent_span_id_;
+  trace_api::CanonicalCode status_code_ = trace_api::CanonicalCode::OK;
+  std::chrono::nanoseconds duration_{0};
+};
+
+/**
+ * Hashes the last 8 bytes of a trace id, which are random.
+ */
+struct TraceIdHash
+{
+  size_t operator()(const trace_api::TraceId &trace_id) const noexcept
+  {
+    uint64_t result;
+    std::memcpy(&result, trace_id.Id().data() + trace_api::TraceId::kSize - 8, sizeof(result));
+    return static_cast<size_t>(result);
+  }
+};
+
+/**
+ * @return the index of the shard a trace belongs to, from the first bytes of
+ * its id, so that it's independent of the bucket in the shard's index.
+ */
+size_t GetShardIndex(const trace_api::TraceId &trace_id, size_t num_shards) noexcept
+{
+  uint32_t result;
+  std::memcpy(&result, trace_id.Id().data(), sizeof(result));
+  return result % num_shards;
+}
+
+/**
+ * Gives the sampler no span attributes.
+ */
+class EmptyKeyValueIterable final : public trace_api::KeyValueIterable
+{
+public:
+  bool ForEachKeyValue(
+      nostd::function_ref<bool(nostd::string_view, opentelemetry::common::AttributeValue)>
+      /*callback*/) const noexcept override
+  {
+    return true;
+  }
+
+  size_t size() const noexcept override { return 0; }
+};
+}  // namespace
+
+struct TailSamplingProcessor::Trace
+{
+  trace_api::TraceId trace_id;
+  std::vector<std::unique_ptr<Recordable>> spans;
+  // Whether a span had an error status or exceeded the latency threshold.
+  bool is_kept = false;
+  std::chrono::steady_clock::time_point last_end_time;
+};
+
+struct TailSamplingProcessor::Shard
+{
+  std::mutex mutex;
+  // The undecided traces, ordered by the time their last span ended, least
+  // recent first. A trace moves to the back when a span of it ends, so the
+  // traces that went quiet are found at the front. Decided traces are spliced
+  // out of the list, so they're passed on without copying or allocating.
+  std::list<Trace> traces;
+  std::unordered_map<trace_api::TraceId, std::list<Trace>::iterator, TraceIdHash> index;
+  size_t num_spans = 0;
+
+  /**
+   * Move a trace from the shard into a list of decided traces.
+   */
+  void Remove(std::list<Trace>::iterator trace, std::list<Trace> &decided) noexcept
+  {
+    num_spans -= trace->spans.size();
+    index.erase(trace->trace_id);
+    decided.splice(decided.end(), traces, trace);
+  }
+};
+
+TailSamplingProcessor::TailSamplingProcessor(std::unique_ptr<SpanProcessor> &&processor,
+                                             const TailSamplingProcessorOptions &options)
+    : processor_{std::move(processor)}, options_(options)
+{
+  options_.num_shards  = std::max<size_t>(1, options_.num_shards);
+  max_spans_per_shard_ = std::max<size_t>(1, options_.max_buffered_spans / options_.num_shards);
+  shards_.reset(new Shard[options_.num_shards]);
+
+  // The worker thread is started last so that it only ever observes a fully
+  // initialized processor.
+  worker_thread_ = std::thread{&TailSamplingProcessor::DoBackgroundWork, this};
+}
+
+TailSamplingProcessor::~TailSamplingProcessor()
+{
+  Shutdown();
+}
+
+std::unique_ptr<Recordable> TailSamplingProcessor::MakeRecordable() noexcept
+{
+  auto recordable = processor_->MakeRecordable();
+  if (recordable == nullptr)
+  {
+    return nullptr;
+  }
+  return std::unique_ptr<Recordable>{new (std::nothrow)
+                                         TailSamplingRecordable{std::move(recordable)}};
+}
+
+void TailSamplingProcessor::OnStart(Recordable &span) noexcept
+{
+  processor_->OnStart(*static_cast<TailSamplingRecordable &>(span).recordable_);
+}
+
+void TailSamplingProcessor::OnEnd(std::unique_ptr<Recordable> &&span) noexcept
+{
+  if (is_shutdown_)
+  {
+    return;
+  }
+
+  auto &recordable = static_cast<TailSamplingRecordable &>(*span);
+  auto &trace_id   = recordable.trace_id_;
+  bool is_root     = !recordable.parent_span_id_.IsValid();
+  auto now         = std::chrono::steady_clock::now();
+
+  bool is_kept = recordable.status_code_ != trace_api::CanonicalCode::OK ||
+                 recordable.duration_ >= options_.latency_threshold;
+
+  auto &shard = shards_[GetShardIndex(trace_id, options_.num_shards)];
+  std::list<Trace> decided;
+  size_t num_evicted = 0;
+  {
+    std::lock_guard<std::mutex> guard{shard.mutex};
+    std::list<Trace>::iterator trace;
+    auto entry = shard.index.find(trace_id);
+    if (entry == shard.index.end())
+    {
+      trace           = shard.traces.emplace(shard.traces.end());
+      trace->trace_id = trace_id;
+      shard.index.emplace(trace_id, trace);
+    }
+    else
+    {
+      trace = entry->second;
+    }
+    trace->spans.push_back(std::move(recordable.recordable_));
+    trace->is_kept |= is_kept;
+    // The time was taken before the lock, so a thread that waited for it may
+    // have an earlier one than the last trace. Keeping the later time keeps
+    // the list ordered.
+    trace->last_end_time = std::max(now, shard.traces.back().last_end_time);
+    shard.traces.splice(shard.traces.end(), shard.traces, trace);
+    ++shard.num_spans;
+
+    if (is_root)
+    {
+      shard.Remove(trace, decided);
+    }
+    while (shard.num_spans > max_spans_per_shard_)
+    {
+      shard.Remove(shard.traces.begin(), decided);
+      ++num_evicted;
+    }
+  }
+
+  if (num_evicted > 0)
+  {
+    evicted_trace_count_.fetch_add(num_evicted, std::memory_order_relaxed);
+  }
+  // Decided traces are passed on without holding the shard's lock.
+  for (auto &trace : decided)
+  {
+    Decide(trace);
+  }
+}
+
+void TailSamplingProcessor::ForceFlush(std::chrono::microseconds timeout) noexcept
+{
+  DecideTracesBefore(std::chrono::steady_clock::time_point::max());
+  processor_->ForceFlush(timeout);
+}
+
+void TailSamplingProcessor::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  {
+    std::lock_guard<std::mutex> guard{shutdown_m_};
+    if (is_shutdown_.exchange(true))
+    {
+      return;
+    }
+  }
+  shutdown_cv_.notify_one();
+  worker_thread_.join();
+
+  DecideTracesBefore(std::chrono::steady_clock::time_point::max());
+  processor_->Shutdown(timeout);
+}
+
+size_t TailSamplingProcessor::GetBufferedSpanCount() const noexcept
+{
+  size_t result = 0;
+  for (size_t i = 0; i < options_.num_shards; ++i)
+  {
+    std::lock_guard<std::mutex> guard{shards_[i].mutex};
+    result += shards_[i].num_spans;
+  }
+  return result;
+}
+
+uint64_t TailSamplingProcessor::GetEvictedTraceCount() const noexcept
+{
+  return evicted_trace_count_.load(std::memory_order_relaxed);
+}
+
+void TailSamplingProcessor::DoBackgroundWork() noexcept
+{
+  // Checking twice per decision_wait decides a quiet trace at most 1.5 times
+  // decision_wait after its last span ended.
+  auto interval =
+      std::max<std::chrono::milliseconds>(std::chrono::milliseconds(1), options_.decision_wait / 2);
+  std::unique_lock<std::mutex> lock{shutdown_m_};
+  while (!shutdown_cv_.wait_for(lock, interval, [this] { return is_shutdown_.load(); }))
+  {
+    lock.unlock();
+    DecideTracesBefore(std::chrono::steady_clock::now() - options_.decision_wait);
+    lock.lock();
+  }
+}
+
+void TailSamplingProcessor::DecideTracesBefore(
+    std::chrono::steady_clock::time_point cutoff) noexcept
+{
+  for (size_t i = 0; i < options_.num_shards; ++i)
+  {
+    auto &shard = shards_[i];
+    std::list<Trace> decided;
+    {
+      std::lock_guard<std::mutex> guard{shard.mutex};
+      // Only the traces that are due are visited.
+      while (!shard.traces.empty() && shard.traces.front().last_end_time <= cutoff)
+      {
+        shard.Remove(shard.traces.begin(), decided);
+      }
+    }
+    for (auto &trace : decided)
+    {
+      Decide(trace);
+    }
+  }
+}
+
+void TailSamplingProcessor::Decide(Trace &trace) noexcept
+{
+  static const EmptyKeyValueIterable kNoAttributes;
+  if (!trace.is_kept &&
+      options_.sampler
+              ->ShouldSample(nullptr, trace.trace_id, "", trace_api::SpanKind::kInternal,
+                             kNoAttributes)
+              .decision != Decision::RECORD_AND_SAMPLE)
+  {
+    return;
+  }
+  for (auto &span : trace.spans)
+  {
+    processor_->OnEnd(std::move(span));
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -24,8 +24,21 @@ nostd::unique_ptr<trace_api::Span> Tracer::StartSpan(
     const trace_api::KeyValueIterable &attributes,
     const trace_api::StartSpanOptions &options) noexcept
 {
-  return nostd::unique_ptr<trace_api::Span>{new (std::nothrow) Span{
-      this->shared_from_this(), processor_.load(), name, attributes, options}};
+  trace_api::TraceId trace_id = id_generator_->GenerateTraceId();
+
+  auto sampling_result = sampler_->ShouldSample(nullptr, trace_id, name, options.kind, attributes);
+  if (sampling_result.decision == Decision::NOT_RECORD)
+  {
+    if (deferred_sampling_predicate_)
+    {
+      return nostd::unique_ptr<trace_api::Span>{new (std::nothrow) Span{
+          this->shared_from_this(), name, attributes, options, trace_id}};
+    }
+    return nostd::unique_ptr<trace_api::Span>{new (std::nothrow) Span{this->shared_from_this()}};
+  }
+  return nostd::unique_ptr<trace_api::Span>{
+      new (std::nothrow) Span{this->shared_from_this(), processor_.load(), name, attributes,
+                              options, trace_id, sampling_result.attributes.get()}};
 }
 
 void Tracer::ForceFlushWithMicroseconds(uint64_t timeout) noexcept
@@ -1,33 +1,118 @@
 #include "opentelemetry/sdk/trace/tracer_provider.h"
 
+#include <new>
+
+#include "opentelemetry/trace/noop.h"
+
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
 {
 namespace trace
 {
-TracerProvider::TracerProvider(std::shared_ptr<SpanProcessor> processor) noexcept
-    : processor_{processor}, tracer_(new Tracer(std::move(processor)))
-{}
+namespace
+{
+/**
+ * @return the tracer handed out when a tracer can't be allocated. It's created
+ * along with the first provider, since allocating it when memory runs out
+ * would likely fail as well. It's leaked, so that it outlives all providers.
+ */
+const std::shared_ptr<opentelemetry::trace::Tracer> &GetNoopTracer() noexcept
+{
+  static auto tracer = new std::shared_ptr<opentelemetry::trace::Tracer>{
+      std::make_shared<opentelemetry::trace::NoopTracer>()};
+  return *tracer;
+}
+}  // namespace
+
+TracerProvider::TracerProvider(std::shared_ptr<SpanProcessor> processor,
+                               std::shared_ptr<Sampler> sampler,
+                               DeferredSamplingPredicate deferred_sampling_predicate,
+                               std::shared_ptr<IdGenerator> id_generator) noexcept
+    : processor_{std::move(processor)},
+      sampler_{std::move(sampler)},
+      deferred_sampling_predicate_{std::move(deferred_sampling_predicate)},
+      id_generator_{std::move(id_generator)},
+      tracers_{std::make_shared<const TracerList>()}
+{
+  GetNoopTracer();
+}
 
 opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> TracerProvider::GetTracer(
     nostd::string_view library_name,
     nostd::string_view library_version) noexcept
 {
-  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer_);
+  auto tracer = FindTracer(*tracers_.load(), library_name, library_version);
+  if (tracer != nullptr)
+  {
+    return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer);
+  }
+
+  tracer = CreateTracer(library_name, library_version);
+  if (tracer == nullptr)
+  {
+    return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(GetNoopTracer());
+  }
+  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer);
+}
+
+std::shared_ptr<Tracer> TracerProvider::CreateTracer(nostd::string_view library_name,
+                                                     nostd::string_view library_version) noexcept
+#if __EXCEPTIONS
+    try
+#endif
+{
+  std::lock_guard<std::mutex> guard{mutex_};
+  auto tracers = tracers_.load();
+  auto tracer  = FindTracer(*tracers, library_name, library_version);
+  if (tracer == nullptr)
+  {
+    tracer = std::make_shared<Tracer>(processor_.load(), SpanSynchronization::kThreadSafe,
+                                      InstrumentationLibrary::Get(library_name, library_version),
+                                      sampler_, deferred_sampling_predicate_, id_generator_);
+    auto new_tracers = std::make_shared<TracerList>(*tracers);
+    new_tracers->push_back(tracer);
+    tracers_.store(std::move(new_tracers));
+  }
+  return tracer;
+}
+#if __EXCEPTIONS
+catch (const std::bad_alloc &)
+{
+  return nullptr;
 }
+#endif
 
 void TracerProvider::SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept
 {
+  std::lock_guard<std::mutex> guard{mutex_};
   processor_.store(processor);
-
-  auto sdkTracer = static_cast<Tracer *>(tracer_.get());
-  sdkTracer->SetProcessor(processor);
+  for (auto &tracer : *tracers_.load())
+  {
+    tracer->SetProcessor(processor);
+  }
 }
 
 std::shared_ptr<SpanProcessor> TracerProvider::GetProcessor() const noexcept
 {
   return processor_.load();
 }
+
+std::shared_ptr<Tracer> TracerProvider::FindTracer(const TracerList &tracers,
+                                                   nostd::string_view library_name,
+                                                   nostd::string_view library_version) noexcept
+{
+  // Processes use few instrumentation libraries, so a linear search is
+  // cheaper than hashing the name.
+  for (auto &tracer : tracers)
+  {
+    auto &library = tracer->GetInstrumentationLibrary();
+    if (library.GetName() == library_name && library.GetVersion() == library_version)
+    {
+      return tracer;
+    }
+  }
+  return nullptr;
+}
 }  // namespace trace
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
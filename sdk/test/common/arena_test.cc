@@ -0,0 +1,74 @@
+#include "opentelemetry/sdk/common/arena.h"
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::Arena;
+
+namespace nostd = opentelemetry::nostd;
+
+TEST(ArenaTest, AllocatesFromInitialBlock)
+{
+  alignas(std::max_align_t) char block[64];
+  Arena arena{block, sizeof(block)};
+  auto first  = static_cast<char *>(arena.Allocate(10, 1));
+  auto second = static_cast<char *>(arena.Allocate(16, 8));
+  EXPECT_EQ(block, first);
+  EXPECT_EQ(block + 16, second);
+  EXPECT_EQ(0, arena.GetNumBlocks());
+}
+
+TEST(ArenaTest, Alignment)
+{
+  alignas(std::max_align_t) char block[64];
+  Arena arena{block, sizeof(block)};
+  arena.Allocate(1, 1);
+  for (size_t alignment = 1; alignment <= alignof(std::max_align_t); alignment *= 2)
+  {
+    auto memory = arena.Allocate(1, alignment);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(memory) % alignment);
+  }
+}
+
+TEST(ArenaTest, SpillsIntoHeapBlocks)
+{
+  alignas(std::max_align_t) char block[64];
+  Arena arena{block, sizeof(block)};
+  arena.Allocate(48);
+  arena.Allocate(48);
+  EXPECT_EQ(1, arena.GetNumBlocks());
+
+  // Allocations larger than a block get a block of their own.
+  auto memory = static_cast<char *>(arena.Allocate(10000, 1));
+  ASSERT_NE(nullptr, memory);
+  memory[9999] = 'x';
+  EXPECT_EQ(2, arena.GetNumBlocks());
+
+  arena.Reset();
+  EXPECT_EQ(0, arena.GetNumBlocks());
+  EXPECT_EQ(block, arena.Allocate(1));
+}
+
+TEST(ArenaTest, CopyString)
+{
+  alignas(std::max_align_t) char block[16];
+  Arena arena{block, sizeof(block)};
+  std::string s = "a string that doesn't fit into the initial block";
+  auto copy     = arena.CopyString(s);
+  s.assign(s.size(), 'x');
+  EXPECT_EQ("a string that doesn't fit into the initial block", copy);
+  EXPECT_TRUE(arena.CopyString("").empty());
+}
+
+TEST(ArenaTest, CopySpan)
+{
+  alignas(std::max_align_t) char block[64];
+  Arena arena{block, sizeof(block)};
+  int64_t values[] = {1, 2, 3};
+  auto copy        = arena.CopySpan(nostd::span<const int64_t>{values});
+  values[0]        = 4;
+  ASSERT_EQ(3, copy.size());
+  EXPECT_EQ(1, copy[0]);
+  EXPECT_EQ(3, copy[2]);
+}
@@ -0,0 +1,104 @@
+#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::AtomicSharedPtr;
+
+TEST(AtomicSharedPtrTest, LoadAndStore)
+{
+  auto first  = std::make_shared<int>(1);
+  auto second = std::make_shared<int>(2);
+  AtomicSharedPtr<int> ptr{first};
+  EXPECT_EQ(first, ptr.load());
+  EXPECT_EQ(first, ptr.load());
+
+  ptr.store(second);
+  EXPECT_EQ(second, ptr.load());
+
+  ptr.store(nullptr);
+  EXPECT_EQ(nullptr, ptr.load());
+}
+
+TEST(AtomicSharedPtrTest, StoreReleasesPreviousValue)
+{
+  std::weak_ptr<int> previous;
+  AtomicSharedPtr<int> ptr{nullptr};
+  {
+    auto value = std::make_shared<int>(1);
+    previous   = value;
+    ptr.store(value);
+  }
+
+  // Read through several slots.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&] { EXPECT_EQ(1, *ptr.load()); });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_FALSE(previous.expired());
+
+  ptr.store(std::make_shared<int>(2));
+  EXPECT_TRUE(previous.expired());
+}
+
+TEST(AtomicSharedPtrTest, ConcurrentLoadAndStore)
+{
+  const int num_values = 1000;
+  AtomicSharedPtr<int> ptr{std::make_shared<int>(0)};
+  std::atomic<bool> is_done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+  {
+    readers.emplace_back([&] {
+      int last_value = 0;
+      while (!is_done)
+      {
+        // Every reader sees the values in the order they were stored.
+        auto value = ptr.load();
+        ASSERT_NE(nullptr, value);
+        EXPECT_GE(*value, last_value);
+        last_value = *value;
+      }
+    });
+  }
+  for (int i = 1; i <= num_values; ++i)
+  {
+    ptr.store(std::make_shared<int>(i));
+  }
+  is_done = true;
+  for (auto &reader : readers)
+  {
+    reader.join();
+  }
+  EXPECT_EQ(num_values, *ptr.load());
+}
+
+TEST(AtomicSharedPtrTest, ExitedThreadsReuseHazardRecords)
+{
+  AtomicSharedPtr<int> ptr{std::make_shared<int>(1)};
+  auto count_records = [] {
+    size_t result = 0;
+    for (auto record = opentelemetry::sdk::detail::GetHazardRecords().load(); record != nullptr;
+         record      = record->next)
+    {
+      ++result;
+    }
+    return result;
+  };
+
+  std::thread{[&] { EXPECT_EQ(1, *ptr.load()); }}.join();
+  auto num_records = count_records();
+  for (int i = 0; i < 10; ++i)
+  {
+    std::thread{[&] { EXPECT_EQ(1, *ptr.load()); }}.join();
+  }
+  EXPECT_EQ(num_records, count_records());
+}
@@ -9,14 +9,21 @@
 #include <vector>
 
 #include "src/common/circular_buffer.h"
+#include "src/common/inline_circular_buffer.h"
+#include "src/common/sharded_circular_buffer.h"
 #include "test/common/baseline_circular_buffer.h"
 using opentelemetry::sdk::common::AtomicUniquePtr;
 using opentelemetry::sdk::common::CircularBuffer;
 using opentelemetry::sdk::common::CircularBufferRange;
+using opentelemetry::sdk::common::InlineCircularBuffer;
+using opentelemetry::sdk::common::ShardedCircularBuffer;
 using opentelemetry::testing::BaselineCircularBuffer;
 
 const int N = 10000;
 
+// The number of elements producers add at once in BM_LockFreeBufferAddMany.
+const int kBatchSize = 16;
+
 static uint64_t ConsumeBufferNumbers(BaselineCircularBuffer<uint64_t> &buffer) noexcept
 {
   uint64_t result = 0;
@@ -41,6 +48,39 @@ static uint64_t ConsumeBufferNumbers(CircularBuffer<uint64_t> &buffer) noexcept
   return result;
 }
 
+static uint64_t ConsumeBufferNumbers(ShardedCircularBuffer<uint64_t> &buffer) noexcept
+{
+  uint64_t result = 0;
+  buffer.Consume(
+      buffer.size(), [&](CircularBufferRange<AtomicUniquePtr<uint64_t>> & range) noexcept {
+        range.ForEach([&](AtomicUniquePtr<uint64_t> & ptr) noexcept {
+          result += *ptr;
+          ptr.Reset();
+          return true;
+        });
+      });
+  return result;
+}
+
+static uint64_t ConsumeBufferNumbers(InlineCircularBuffer<uint64_t> &buffer) noexcept
+{
+  uint64_t result = 0;
+  buffer.Consume(buffer.size(), [&](uint64_t &&x) noexcept { result += x; });
+  return result;
+}
+
+template <class Buffer>
+static bool AddBufferNumber(Buffer &buffer, uint64_t x) noexcept
+{
+  std::unique_ptr<uint64_t> element{new uint64_t{x}};
+  return buffer.Add(element);
+}
+
+static bool AddBufferNumber(InlineCircularBuffer<uint64_t> &buffer, uint64_t x) noexcept
+{
+  return buffer.Add(x);
+}
+
 template <class Buffer>
 static void GenerateNumbersForThread(Buffer &buffer, int n, std::atomic<uint64_t> &sum) noexcept
 {
@@ -48,22 +88,49 @@ static void GenerateNumbersForThread(Buffer &buffer, int n, std::atomic<uint64_t
   for (int i = 0; i < n; ++i)
   {
     auto x = random_number_generator();
-    std::unique_ptr<uint64_t> element{new uint64_t{x}};
-    if (buffer.Add(element))
+    if (AddBufferNumber(buffer, x))
     {
       sum += x;
     }
   }
 }
 
+static void GenerateNumberBatchesForThread(CircularBuffer<uint64_t> &buffer,
+                                           int n,
+                                           std::atomic<uint64_t> &sum) noexcept
+{
+  thread_local std::mt19937_64 random_number_generator{std::random_device{}()};
+  std::vector<std::unique_ptr<uint64_t>> batch(kBatchSize);
+  for (int i = 0; i < n; i += kBatchSize)
+  {
+    uint64_t batch_sum = 0;
+    for (auto &element : batch)
+    {
+      auto x = random_number_generator();
+      element.reset(new uint64_t{x});
+      batch_sum += x;
+    }
+    if (buffer.AddMany(batch))
+    {
+      sum += batch_sum;
+    }
+  }
+}
+
+template <class Buffer>
+using Producer = void (*)(Buffer &, int, std::atomic<uint64_t> &);
+
 template <class Buffer>
-static uint64_t GenerateNumbers(Buffer &buffer, int num_threads, int n) noexcept
+static uint64_t GenerateNumbers(Buffer &buffer,
+                                int num_threads,
+                                int n,
+                                Producer<Buffer> producer) noexcept
 {
   std::atomic<uint64_t> sum{0};
   std::vector<std::thread> threads(num_threads);
   for (auto &thread : threads)
   {
-    thread = std::thread{GenerateNumbersForThread<Buffer>, std::ref(buffer), n, std::ref(sum)};
+    thread = std::thread{producer, std::ref(buffer), n, std::ref(sum)};
   }
   for (auto &thread : threads)
   {
@@ -83,13 +150,16 @@ static void ConsumeNumbers(Buffer &buffer, uint64_t &sum, std::atomic<bool> &fin
 }
 
 template <class Buffer>
-static void RunSimulation(Buffer &buffer, int num_threads, int n) noexcept
+static void RunSimulation(Buffer &buffer,
+                          int num_threads,
+                          int n,
+                          Producer<Buffer> producer = GenerateNumbersForThread<Buffer>) noexcept
 {
   std::atomic<bool> finished{false};
   uint64_t consumer_sum{0};
   std::thread consumer_thread{ConsumeNumbers<Buffer>, std::ref(buffer), std::ref(consumer_sum),
                               std::ref(finished)};
-  uint64_t producer_sum = GenerateNumbers(buffer, num_threads, n);
+  uint64_t producer_sum = GenerateNumbers(buffer, num_threads, n, producer);
   finished              = true;
   consumer_thread.join();
   if (consumer_sum != producer_sum)
@@ -111,7 +181,7 @@ static void BM_BaselineBuffer(benchmark::State &state)
   }
 }
 
-BENCHMARK(BM_BaselineBuffer)->Arg(1)->Arg(2)->Arg(4);
+BENCHMARK(BM_BaselineBuffer)->RangeMultiplier(2)->Range(1, 64);
 
 static void BM_LockFreeBuffer(benchmark::State &state)
 {
@@ -125,6 +195,61 @@ static void BM_LockFreeBuffer(benchmark::State &state)
   }
 }
 
-BENCHMARK(BM_LockFreeBuffer)->Arg(1)->Arg(2)->Arg(4);
+BENCHMARK(BM_LockFreeBuffer)->RangeMultiplier(2)->Range(1, 64);
+
+static void BM_LockFreeBufferAddMany(benchmark::State &state)
+{
+  const size_t max_elements = 500;
+  auto num_threads          = state.range(0);
+  const int n               = N / num_threads;
+  CircularBuffer<uint64_t> buffer{max_elements};
+  for (auto _ : state)
+  {
+    RunSimulation(buffer, num_threads, n, GenerateNumberBatchesForThread);
+  }
+}
+
+BENCHMARK(BM_LockFreeBufferAddMany)->RangeMultiplier(2)->Range(1, 64);
+
+static void BM_InlineBuffer(benchmark::State &state)
+{
+  const size_t max_elements = 512;
+  auto num_threads          = state.range(0);
+  const int n               = N / num_threads;
+  InlineCircularBuffer<uint64_t> buffer{max_elements};
+  for (auto _ : state)
+  {
+    RunSimulation(buffer, num_threads, n);
+  }
+}
+
+BENCHMARK(BM_InlineBuffer)->RangeMultiplier(2)->Range(1, 64);
+
+static void BM_ShardedBuffer(benchmark::State &state)
+{
+  const size_t max_elements = 500;
+  auto num_threads          = state.range(0);
+  auto num_shards           = state.range(1);
+  const int n               = N / num_threads;
+  ShardedCircularBuffer<uint64_t> buffer{max_elements, static_cast<size_t>(num_shards)};
+  for (auto _ : state)
+  {
+    RunSimulation(buffer, num_threads, n);
+  }
+}
+
+// Compares against BM_LockFreeBuffer with the same number of producer threads.
+static void ShardedBufferArguments(benchmark::internal::Benchmark *benchmark)
+{
+  for (int num_threads = 1; num_threads <= 64; num_threads *= 2)
+  {
+    for (int num_shards : {4, 16})
+    {
+      benchmark->Args({num_threads, num_shards});
+    }
+  }
+}
+
+BENCHMARK(BM_ShardedBuffer)->Apply(ShardedBufferArguments);
 
 BENCHMARK_MAIN();
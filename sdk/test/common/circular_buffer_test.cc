@@ -1,5 +1,6 @@
 #include "src/common/circular_buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <random>
 #include <thread>
@@ -55,8 +56,11 @@ void RunNumberConsumer(CircularBuffer<uint32_t> &buffer,
 {
   while (true)
   {
+    // Read the exit flag before peeking so that elements added before the
+    // producers finished are never missed.
+    bool exiting   = exit;
     auto allotment = buffer.Peek();
-    if (exit && allotment.empty())
+    if (exiting && allotment.empty())
     {
       return;
     }
@@ -134,6 +138,138 @@ TEST(CircularBufferTest, Consume)
   EXPECT_EQ(count, 5);
 }
 
+TEST(CircularBufferTest, MaxSizeIsNotRounded)
+{
+  CircularBuffer<int> buffer{5};
+  EXPECT_EQ(buffer.max_size(), 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    std::unique_ptr<int> x{new int{i}};
+    EXPECT_TRUE(buffer.Add(x));
+  }
+  std::unique_ptr<int> x{new int{5}};
+  EXPECT_FALSE(buffer.Add(x));
+}
+
+TEST(CircularBufferTest, PeekWrapsAround)
+{
+  CircularBuffer<int> buffer{4};
+  for (int i = 0; i < 3; ++i)
+  {
+    std::unique_ptr<int> x{new int{i}};
+    EXPECT_TRUE(buffer.Add(x));
+  }
+  buffer.Consume(2);
+  for (int i = 3; i < 6; ++i)
+  {
+    std::unique_ptr<int> x{new int{i}};
+    EXPECT_TRUE(buffer.Add(x));
+  }
+  std::vector<int> numbers;
+  buffer.Peek().ForEach([&](const AtomicUniquePtr<int> &ptr) {
+    numbers.push_back(*ptr);
+    return true;
+  });
+  EXPECT_EQ(numbers, (std::vector<int>{2, 3, 4, 5}));
+}
+
+TEST(CircularBufferTest, AddMany)
+{
+  CircularBuffer<int> buffer{5};
+  std::vector<std::unique_ptr<int>> ptrs;
+  for (int i = 0; i < 3; ++i)
+  {
+    ptrs.emplace_back(new int{i});
+  }
+  EXPECT_TRUE(buffer.AddMany(ptrs));
+  EXPECT_EQ(buffer.size(), 3);
+  for (auto &ptr : ptrs)
+  {
+    EXPECT_EQ(ptr, nullptr);
+  }
+
+  // There's only room for two more elements, so none are added.
+  for (int i = 0; i < 3; ++i)
+  {
+    ptrs[i].reset(new int{3 + i});
+  }
+  EXPECT_FALSE(buffer.AddMany(ptrs));
+  EXPECT_EQ(buffer.size(), 3);
+  for (int i = 0; i < 3; ++i)
+  {
+    ASSERT_NE(ptrs[i], nullptr);
+    EXPECT_EQ(*ptrs[i], 3 + i);
+  }
+
+  std::vector<int> numbers;
+  EXPECT_EQ(buffer.ConsumeAll([&](CircularBufferRange<AtomicUniquePtr<int>> range) noexcept {
+    range.ForEach([&](AtomicUniquePtr<int> &ptr) {
+      numbers.push_back(*ptr);
+      ptr.Reset();
+      return true;
+    });
+  }),
+            3);
+  EXPECT_EQ(numbers, (std::vector<int>{0, 1, 2}));
+  EXPECT_TRUE(buffer.empty());
+
+  // The elements wrap around the end of the buffer.
+  EXPECT_TRUE(buffer.AddMany(ptrs));
+  EXPECT_EQ(buffer.size(), 3);
+}
+
+TEST(CircularBufferTest, AddManySimulation)
+{
+  const int num_producer_threads = 4;
+  const int n                    = 10000;
+  const int batch_size           = 4;
+  CircularBuffer<uint32_t> buffer{50};
+  std::vector<std::vector<uint32_t>> thread_numbers(num_producer_threads);
+  std::vector<std::thread> producers;
+  for (int thread_index = 0; thread_index < num_producer_threads; ++thread_index)
+  {
+    producers.emplace_back([&, thread_index] {
+      std::vector<std::unique_ptr<uint32_t>> batch(batch_size);
+      for (int i = 0; i < n; i += batch_size)
+      {
+        for (int j = 0; j < batch_size; ++j)
+        {
+          batch[j].reset(new uint32_t(thread_index * n + i + j));
+        }
+        std::vector<uint32_t> values;
+        for (auto &ptr : batch)
+        {
+          values.push_back(*ptr);
+        }
+        if (buffer.AddMany(batch))
+        {
+          thread_numbers[thread_index].insert(thread_numbers[thread_index].end(), values.begin(),
+                                              values.end());
+        }
+      }
+    });
+  }
+  std::vector<uint32_t> consumer_numbers;
+  std::atomic<bool> exit{false};
+  auto consumer = std::thread{RunNumberConsumer, std::ref(buffer), std::ref(exit),
+                              std::ref(consumer_numbers)};
+  for (auto &producer : producers)
+  {
+    producer.join();
+  }
+  exit = true;
+  consumer.join();
+
+  std::vector<uint32_t> producer_numbers;
+  for (auto &numbers : thread_numbers)
+  {
+    producer_numbers.insert(producer_numbers.end(), numbers.begin(), numbers.end());
+  }
+  std::sort(producer_numbers.begin(), producer_numbers.end());
+  std::sort(consumer_numbers.begin(), consumer_numbers.end());
+  EXPECT_EQ(producer_numbers, consumer_numbers);
+}
+
 TEST(CircularBufferTest, Simulation)
 {
   const int num_producer_threads = 4;
@@ -156,3 +292,56 @@ TEST(CircularBufferTest, Simulation)
     EXPECT_EQ(producer_numbers, consumer_numbers);
   }
 }
+
+TEST(CircularBufferTest, ConsumeConcurrently)
+{
+  const int num_producer_threads = 2;
+  const int num_consumer_threads = 3;
+  const int n                    = 25000;
+  CircularBuffer<uint32_t> buffer{64};
+  std::vector<uint32_t> producer_numbers;
+  auto producers = std::thread{RunNumberProducers, std::ref(buffer), std::ref(producer_numbers),
+                               num_producer_threads, n};
+  std::atomic<bool> exit{false};
+  std::vector<std::vector<uint32_t>> thread_numbers(num_consumer_threads);
+  std::vector<std::thread> consumers;
+  for (int thread_index = 0; thread_index < num_consumer_threads; ++thread_index)
+  {
+    consumers.emplace_back([&, thread_index] {
+      auto &numbers = thread_numbers[thread_index];
+      while (true)
+      {
+        bool exiting      = exit;
+        auto num_consumed = buffer.ConsumeConcurrently(
+            7, [&](CircularBufferRange<AtomicUniquePtr<uint32_t>> range) noexcept {
+              range.ForEach([&](AtomicUniquePtr<uint32_t> &ptr) {
+                assert(!ptr.IsNull());
+                numbers.push_back(*ptr);
+                ptr.Reset();
+                return true;
+              });
+            });
+        if (exiting && num_consumed == 0)
+        {
+          return;
+        }
+      }
+    });
+  }
+  producers.join();
+  exit = true;
+  for (auto &consumer : consumers)
+  {
+    consumer.join();
+  }
+
+  std::vector<uint32_t> consumer_numbers;
+  for (auto &numbers : thread_numbers)
+  {
+    consumer_numbers.insert(consumer_numbers.end(), numbers.begin(), numbers.end());
+  }
+  EXPECT_TRUE(buffer.empty());
+  std::sort(producer_numbers.begin(), producer_numbers.end());
+  std::sort(consumer_numbers.begin(), consumer_numbers.end());
+  EXPECT_EQ(producer_numbers, consumer_numbers);
+}
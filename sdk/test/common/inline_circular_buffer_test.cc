@@ -0,0 +1,132 @@
+#include "src/common/inline_circular_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::InlineCircularBuffer;
+
+static std::vector<int> ConsumeNumbers(InlineCircularBuffer<int> &buffer, size_t n)
+{
+  std::vector<int> result;
+  buffer.Consume(n, [&](int &&x) noexcept { result.push_back(x); });
+  return result;
+}
+
+TEST(InlineCircularBufferTest, AddAndConsume)
+{
+  InlineCircularBuffer<int> buffer{4};
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_TRUE(buffer.Add(1));
+  EXPECT_TRUE(buffer.Add(2));
+  EXPECT_EQ(buffer.size(), 2);
+  EXPECT_EQ(ConsumeNumbers(buffer, 1), (std::vector<int>{1}));
+  EXPECT_EQ(ConsumeNumbers(buffer, 10), (std::vector<int>{2}));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(InlineCircularBufferTest, CapacityIsRoundedUpToPowerOfTwo)
+{
+  EXPECT_EQ(InlineCircularBuffer<int>{1}.capacity(), 1);
+  EXPECT_EQ(InlineCircularBuffer<int>{4}.capacity(), 4);
+  EXPECT_EQ(InlineCircularBuffer<int>{5}.capacity(), 8);
+}
+
+TEST(InlineCircularBufferTest, Full)
+{
+  InlineCircularBuffer<int> buffer{4};
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_TRUE(buffer.Add(i));
+  }
+  EXPECT_FALSE(buffer.Add(4));
+  EXPECT_EQ(ConsumeNumbers(buffer, 1), (std::vector<int>{0}));
+  EXPECT_TRUE(buffer.Add(4));
+  EXPECT_EQ(ConsumeNumbers(buffer, 4), (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(InlineCircularBufferTest, WrapAround)
+{
+  InlineCircularBuffer<int> buffer{4};
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_TRUE(buffer.Add(2 * i));
+    EXPECT_TRUE(buffer.Add(2 * i + 1));
+    EXPECT_EQ(ConsumeNumbers(buffer, 2), (std::vector<int>{2 * i, 2 * i + 1}));
+  }
+}
+
+TEST(InlineCircularBufferTest, MoveOnlyElements)
+{
+  InlineCircularBuffer<std::unique_ptr<int>> buffer{2};
+  std::unique_ptr<int> x{new int{11}};
+  EXPECT_TRUE(buffer.Add(x));
+  EXPECT_EQ(x, nullptr);
+
+  // An element that isn't added is left untouched.
+  std::unique_ptr<int> y{new int{22}};
+  EXPECT_TRUE(buffer.Add(std::unique_ptr<int>{new int{33}}));
+  EXPECT_FALSE(buffer.Add(y));
+  ASSERT_NE(y, nullptr);
+  EXPECT_EQ(*y, 22);
+
+  std::vector<int> result;
+  buffer.Consume(1, [&](std::unique_ptr<int> &&ptr) noexcept { result.push_back(*ptr); });
+  EXPECT_EQ(result, (std::vector<int>{11}));
+
+  // Remaining elements are destroyed with the buffer.
+}
+
+TEST(InlineCircularBufferTest, Simulation)
+{
+  const int num_producer_threads = 4;
+  const int n                    = 25000;
+  InlineCircularBuffer<int> buffer{100};
+  std::vector<std::vector<int>> producer_numbers(num_producer_threads);
+  std::vector<int> consumer_numbers;
+  std::atomic<bool> exit{false};
+  std::thread consumer{[&] {
+    while (true)
+    {
+      bool exiting = exit;
+      auto numbers = ConsumeNumbers(buffer, 7);
+      consumer_numbers.insert(consumer_numbers.end(), numbers.begin(), numbers.end());
+      if (exiting && buffer.empty())
+      {
+        return;
+      }
+    }
+  }};
+  std::vector<std::thread> producers;
+  for (int thread_index = 0; thread_index < num_producer_threads; ++thread_index)
+  {
+    producers.emplace_back([&, thread_index] {
+      for (int i = 0; i < n; ++i)
+      {
+        auto value = thread_index * n + i;
+        if (buffer.Add(value))
+        {
+          producer_numbers[thread_index].push_back(value);
+        }
+      }
+    });
+  }
+  for (auto &producer : producers)
+  {
+    producer.join();
+  }
+  exit = true;
+  consumer.join();
+
+  std::vector<int> all_producer_numbers;
+  for (auto &numbers : producer_numbers)
+  {
+    all_producer_numbers.insert(all_producer_numbers.end(), numbers.begin(), numbers.end());
+  }
+  std::sort(all_producer_numbers.begin(), all_producer_numbers.end());
+  std::sort(consumer_numbers.begin(), consumer_numbers.end());
+  EXPECT_EQ(all_producer_numbers, consumer_numbers);
+}
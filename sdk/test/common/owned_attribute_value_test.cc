@@ -0,0 +1,104 @@
+#include "opentelemetry/sdk/common/owned_attribute_value.h"
+
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::OwnedAttributeValue;
+
+namespace nostd = opentelemetry::nostd;
+
+TEST(OwnedAttributeValueTest, Scalars)
+{
+  EXPECT_EQ(false, nostd::get<bool>(OwnedAttributeValue().Get()));
+  EXPECT_EQ(true, nostd::get<bool>(OwnedAttributeValue(true).Get()));
+  EXPECT_EQ(-1, nostd::get<int>(OwnedAttributeValue(-1).Get()));
+  EXPECT_EQ(-2, nostd::get<int64_t>(OwnedAttributeValue(int64_t{-2}).Get()));
+  EXPECT_EQ(3u, nostd::get<unsigned int>(OwnedAttributeValue(3u).Get()));
+  EXPECT_EQ(4u, nostd::get<uint64_t>(OwnedAttributeValue(uint64_t{4}).Get()));
+  EXPECT_EQ(0.5, nostd::get<double>(OwnedAttributeValue(0.5).Get()));
+}
+
+TEST(OwnedAttributeValueTest, Strings)
+{
+  for (std::string s : {"", "short", "a string that's too long to be stored inline"})
+  {
+    std::string copy = s;
+    OwnedAttributeValue value{nostd::string_view{copy}};
+    copy.assign(copy.size(), 'x');
+    EXPECT_EQ(s, nostd::get<nostd::string_view>(value.Get()));
+  }
+}
+
+TEST(OwnedAttributeValueTest, Arrays)
+{
+  int short_array[]    = {1, 2, 3};
+  int64_t long_array[]  = {1, 2, 3, 4, 5, 6, 7, 8};
+  OwnedAttributeValue short_value{nostd::span<const int>{short_array}};
+  OwnedAttributeValue long_value{nostd::span<const int64_t>{long_array}};
+  short_array[0] = 0;
+  long_array[0]  = 0;
+
+  auto short_copy = nostd::get<nostd::span<const int>>(short_value.Get());
+  ASSERT_EQ(3, short_copy.size());
+  EXPECT_EQ(1, short_copy[0]);
+  EXPECT_EQ(3, short_copy[2]);
+  auto long_copy = nostd::get<nostd::span<const int64_t>>(long_value.Get());
+  ASSERT_EQ(8, long_copy.size());
+  EXPECT_EQ(1, long_copy[0]);
+  EXPECT_EQ(8, long_copy[7]);
+}
+
+TEST(OwnedAttributeValueTest, StringArrays)
+{
+  std::string first = "first", second = "second";
+  nostd::string_view strings[] = {first, "", second};
+  OwnedAttributeValue value{nostd::span<const nostd::string_view>{strings}};
+  first.assign(first.size(), 'x');
+  second.assign(second.size(), 'x');
+
+  auto copy = nostd::get<nostd::span<const nostd::string_view>>(value.Get());
+  ASSERT_EQ(3, copy.size());
+  EXPECT_EQ("first", copy[0]);
+  EXPECT_EQ("", copy[1]);
+  EXPECT_EQ("second", copy[2]);
+}
+
+TEST(OwnedAttributeValueTest, CopyAndMove)
+{
+  OwnedAttributeValue value{nostd::string_view{"a string that's too long to be stored inline"}};
+  OwnedAttributeValue copy{value};
+  EXPECT_NE(nostd::get<nostd::string_view>(value.Get()).data(),
+            nostd::get<nostd::string_view>(copy.Get()).data());
+
+  OwnedAttributeValue moved{std::move(copy)};
+  EXPECT_EQ(nostd::get<nostd::string_view>(value.Get()),
+            nostd::get<nostd::string_view>(moved.Get()));
+
+  value = 1;
+  EXPECT_EQ(1, nostd::get<int>(value.Get()));
+  value = moved;
+  EXPECT_EQ("a string that's too long to be stored inline",
+            nostd::get<nostd::string_view>(value.Get()));
+}
+
+TEST(OwnedAttributeValueTest, AssignOwnView)
+{
+  OwnedAttributeValue value{nostd::string_view{"a string that's too long to be stored inline"}};
+  value = value.Get();
+  EXPECT_EQ("a string that's too long to be stored inline",
+            nostd::get<nostd::string_view>(value.Get()));
+
+  const std::string strings[]      = {"first", "second"};
+  const nostd::string_view views[] = {strings[0], strings[1]};
+  OwnedAttributeValue array{nostd::span<const nostd::string_view>{views}};
+  array       = array.Get();
+  auto result = nostd::get<nostd::span<const nostd::string_view>>(array.Get());
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ("first", result[0]);
+  EXPECT_EQ("second", result[1]);
+
+  OwnedAttributeValue inline_value{nostd::string_view{"short"}};
+  inline_value = inline_value.Get();
+  EXPECT_EQ("short", nostd::get<nostd::string_view>(inline_value.Get()));
+}
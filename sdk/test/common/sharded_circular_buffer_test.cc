@@ -0,0 +1,230 @@
+#include "src/common/sharded_circular_buffer.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::AtomicUniquePtr;
+using opentelemetry::sdk::common::CircularBufferRange;
+using opentelemetry::sdk::common::ShardedCircularBuffer;
+
+static std::vector<int> ConsumeNumbers(ShardedCircularBuffer<int> &buffer, size_t n)
+{
+  std::vector<int> result;
+  buffer.Consume(
+      n, [&](CircularBufferRange<AtomicUniquePtr<int>> range) noexcept {
+        range.ForEach([&](AtomicUniquePtr<int> &ptr) {
+          result.push_back(*ptr);
+          ptr.Reset();
+          return true;
+        });
+      });
+  return result;
+}
+
+static bool AddNumber(ShardedCircularBuffer<int> &buffer, int value)
+{
+  std::unique_ptr<int> x{new int{value}};
+  return buffer.Add(x);
+}
+
+TEST(ShardedCircularBufferTest, AddAndConsume)
+{
+  ShardedCircularBuffer<int> buffer{10, 1};
+  EXPECT_TRUE(buffer.empty());
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_TRUE(AddNumber(buffer, i));
+  }
+  EXPECT_EQ(buffer.size(), 5);
+  EXPECT_EQ(ConsumeNumbers(buffer, 3), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(ConsumeNumbers(buffer, 10), (std::vector<int>{3, 4}));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(ShardedCircularBufferTest, CapacityIsSplitBetweenShards)
+{
+  ShardedCircularBuffer<int> buffer{10, 2};
+  EXPECT_EQ(buffer.num_shards(), 2);
+  EXPECT_EQ(buffer.max_size(), 10);
+
+  // A single thread only writes into its own shard.
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_TRUE(AddNumber(buffer, i));
+  }
+  EXPECT_FALSE(AddNumber(buffer, 5));
+
+  // Another thread is assigned to the other shard.
+  std::thread thread{[&] {
+    for (int i = 0; i < 5; ++i)
+    {
+      EXPECT_TRUE(AddNumber(buffer, 10 + i));
+    }
+  }};
+  thread.join();
+  EXPECT_EQ(buffer.size(), 10);
+
+  // Elements from the same thread are consumed in order.
+  auto numbers = ConsumeNumbers(buffer, 10);
+  ASSERT_EQ(numbers.size(), 10);
+  auto first_shard = std::vector<int>{numbers.begin(), numbers.begin() + 5};
+  std::sort(numbers.begin(), numbers.end());
+  EXPECT_EQ(numbers, (std::vector<int>{0, 1, 2, 3, 4, 10, 11, 12, 13, 14}));
+  EXPECT_TRUE(std::is_sorted(first_shard.begin(), first_shard.end()));
+}
+
+TEST(ShardedCircularBufferTest, CapacityAddsUpToMaxSize)
+{
+  ShardedCircularBuffer<int> uneven{10, 4};
+  EXPECT_EQ(uneven.num_shards(), 4);
+  EXPECT_EQ(uneven.max_size(), 10);
+
+  ShardedCircularBuffer<int> small{3, 8};
+  EXPECT_EQ(small.num_shards(), 3);
+  EXPECT_EQ(small.max_size(), 3);
+}
+
+TEST(ShardedCircularBufferTest, Clear)
+{
+  ShardedCircularBuffer<int> buffer{10, 4};
+  EXPECT_TRUE(AddNumber(buffer, 1));
+  buffer.Clear();
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(ShardedCircularBufferTest, Simulation)
+{
+  const int num_producer_threads = 4;
+  const int n                    = 25000;
+  for (size_t num_shards : {1, 2, 3, 8})
+  {
+    ShardedCircularBuffer<int> buffer{100, num_shards};
+    std::vector<std::vector<int>> producer_numbers(num_producer_threads);
+    std::vector<int> consumer_numbers;
+    std::atomic<bool> exit{false};
+    std::thread consumer{[&] {
+      while (true)
+      {
+        bool exiting = exit;
+        auto numbers = ConsumeNumbers(buffer, 7);
+        consumer_numbers.insert(consumer_numbers.end(), numbers.begin(), numbers.end());
+        if (exiting && buffer.empty())
+        {
+          return;
+        }
+      }
+    }};
+    std::vector<std::thread> producers;
+    for (int thread_index = 0; thread_index < num_producer_threads; ++thread_index)
+    {
+      producers.emplace_back([&, thread_index] {
+        for (int i = 0; i < n; ++i)
+        {
+          auto value = thread_index * n + i;
+          if (AddNumber(buffer, value))
+          {
+            producer_numbers[thread_index].push_back(value);
+          }
+        }
+      });
+    }
+    for (auto &producer : producers)
+    {
+      producer.join();
+    }
+    exit = true;
+    consumer.join();
+
+    std::vector<int> all_producer_numbers;
+    for (auto &numbers : producer_numbers)
+    {
+      all_producer_numbers.insert(all_producer_numbers.end(), numbers.begin(), numbers.end());
+    }
+    std::sort(all_producer_numbers.begin(), all_producer_numbers.end());
+    std::sort(consumer_numbers.begin(), consumer_numbers.end());
+    EXPECT_EQ(all_producer_numbers, consumer_numbers);
+  }
+}
+
+TEST(ShardedCircularBufferTest, ConsumeConcurrently)
+{
+  ShardedCircularBuffer<int> buffer{100, 4};
+  std::vector<std::thread> producers;
+  for (int thread_index = 0; thread_index < 4; ++thread_index)
+  {
+    producers.emplace_back([&, thread_index] {
+      for (int i = 0; i < 25; ++i)
+      {
+        EXPECT_TRUE(AddNumber(buffer, thread_index * 25 + i));
+      }
+    });
+  }
+  for (auto &producer : producers)
+  {
+    producer.join();
+  }
+
+  std::vector<std::vector<int>> thread_numbers(3);
+  std::vector<std::thread> consumers;
+  for (auto &numbers : thread_numbers)
+  {
+    consumers.emplace_back([&] {
+      while (buffer.ConsumeConcurrently(
+                 10, [&](CircularBufferRange<AtomicUniquePtr<int>> range) noexcept {
+                   range.ForEach([&](AtomicUniquePtr<int> &ptr) {
+                     numbers.push_back(*ptr);
+                     ptr.Reset();
+                     return true;
+                   });
+                 }) > 0)
+      {
+      }
+    });
+  }
+  for (auto &consumer : consumers)
+  {
+    consumer.join();
+  }
+
+  std::vector<int> all_numbers;
+  for (auto &numbers : thread_numbers)
+  {
+    all_numbers.insert(all_numbers.end(), numbers.begin(), numbers.end());
+  }
+  std::sort(all_numbers.begin(), all_numbers.end());
+  ASSERT_EQ(all_numbers.size(), 100);
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(all_numbers[i], i);
+  }
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(ShardedCircularBufferTest, AddEvictingOldest)
+{
+  ShardedCircularBuffer<int> buffer{4, 2};
+  std::vector<int> evicted;
+  auto add_evicting_oldest = [&](int value) {
+    std::unique_ptr<int> x{new int{value}};
+    return buffer.AddEvictingOldest(
+        x, 1, [&](CircularBufferRange<AtomicUniquePtr<int>> range) noexcept {
+          range.ForEach([&](AtomicUniquePtr<int> &ptr) {
+            evicted.push_back(*ptr);
+            ptr.Reset();
+            return true;
+          });
+        });
+  };
+
+  // Only the shard of the calling thread is full, so its oldest elements are
+  // evicted even though the other shard is empty.
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_TRUE(add_evicting_oldest(i));
+  }
+  EXPECT_EQ(evicted, (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(buffer.size(), 2);
+  EXPECT_EQ(ConsumeNumbers(buffer, 4), (std::vector<int>{3, 4}));
+}
@@ -0,0 +1,80 @@
+#include "src/common/threshold_waiter.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::ThresholdWaiter;
+
+static std::chrono::steady_clock::time_point After(std::chrono::milliseconds duration)
+{
+  return std::chrono::steady_clock::now() + duration;
+}
+
+TEST(ThresholdWaiterTest, TimesOut)
+{
+  ThresholdWaiter waiter;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(waiter.WaitUntil(5, After(std::chrono::milliseconds(10)), [] { return size_t{4}; }));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+}
+
+TEST(ThresholdWaiterTest, ThresholdAlreadyReached)
+{
+  ThresholdWaiter waiter;
+  EXPECT_TRUE(waiter.WaitUntil(5, After(std::chrono::hours(1)), [] { return size_t{5}; }));
+}
+
+TEST(ThresholdWaiterTest, WakeIsNotLost)
+{
+  ThresholdWaiter waiter;
+  waiter.Wake();
+  EXPECT_TRUE(waiter.WaitUntil(5, After(std::chrono::hours(1)), [] { return size_t{0}; }));
+
+  // The wake-up is consumed by the first wait.
+  EXPECT_FALSE(waiter.WaitUntil(5, After(std::chrono::milliseconds(1)), [] { return size_t{0}; }));
+}
+
+TEST(ThresholdWaiterTest, NotifyAddedWithoutWaiter)
+{
+  ThresholdWaiter waiter;
+  int num_size_calls = 0;
+  waiter.NotifyAdded([&] {
+    ++num_size_calls;
+    return size_t{100};
+  });
+
+  // The queue size is only looked at while the consumer waits.
+  EXPECT_EQ(num_size_calls, 0);
+  EXPECT_FALSE(waiter.WaitUntil(200, After(std::chrono::milliseconds(1)), [] { return size_t{100}; }));
+}
+
+TEST(ThresholdWaiterTest, ProducersWakeConsumer)
+{
+  const size_t threshold = 100;
+  ThresholdWaiter waiter;
+  std::atomic<size_t> queue_size{0};
+  auto get_queue_size = [&] { return queue_size.load(); };
+
+  std::thread consumer{[&] {
+    EXPECT_TRUE(waiter.WaitUntil(threshold, After(std::chrono::seconds(10)), get_queue_size));
+    EXPECT_GE(queue_size, threshold);
+  }};
+  std::thread producers[4];
+  for (auto &producer : producers)
+  {
+    producer = std::thread{[&] {
+      for (size_t i = 0; i < threshold; ++i)
+      {
+        ++queue_size;
+        waiter.NotifyAdded(get_queue_size);
+      }
+    }};
+  }
+  for (auto &producer : producers)
+  {
+    producer.join();
+  }
+  consumer.join();
+}
@@ -0,0 +1,135 @@
+#include "opentelemetry/sdk/trace/arena_span_data.h"
+#include "opentelemetry/nostd/variant.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::trace::ArenaSpanData;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+std::vector<std::string> GetAttributeKeys(const ArenaSpanData &data)
+{
+  std::vector<std::string> result;
+  data.ForEachAttribute(
+      [&](nostd::string_view key, const opentelemetry::common::AttributeValue &) {
+        result.push_back(std::string(key));
+        return true;
+      });
+  return result;
+}
+}  // namespace
+
+TEST(ArenaSpanData, DefaultValues)
+{
+  opentelemetry::trace::SpanId zero_span_id;
+  ArenaSpanData data;
+
+  ASSERT_EQ(data.GetSpanId(), zero_span_id);
+  ASSERT_EQ(data.GetName(), "");
+  ASSERT_EQ(data.GetStatus(), opentelemetry::trace::CanonicalCode::OK);
+  ASSERT_EQ(data.GetDescription(), "");
+  ASSERT_EQ(data.GetDuration(), std::chrono::nanoseconds(0));
+  ASSERT_EQ(data.GetAttributeCount(), 0);
+}
+
+TEST(ArenaSpanData, Set)
+{
+  ArenaSpanData data;
+  std::string name        = "span name";
+  std::string description = "description";
+  data.SetName(name);
+  data.SetStatus(opentelemetry::trace::CanonicalCode::UNKNOWN, description);
+  data.SetDuration(std::chrono::nanoseconds(1000000));
+  name.assign(name.size(), 'x');
+  description.assign(description.size(), 'x');
+
+  ASSERT_EQ(data.GetName(), "span name");
+  ASSERT_EQ(data.GetStatus(), opentelemetry::trace::CanonicalCode::UNKNOWN);
+  ASSERT_EQ(data.GetDescription(), "description");
+  ASSERT_EQ(data.GetDuration(), std::chrono::nanoseconds(1000000));
+}
+
+TEST(ArenaSpanData, AttributesAreCopied)
+{
+  ArenaSpanData data;
+  {
+    std::string key   = "string";
+    std::string value = "value";
+    data.SetAttribute(key, nostd::string_view{value});
+    nostd::string_view strings[] = {value, "other"};
+    data.SetAttribute("strings", nostd::span<const nostd::string_view>{strings});
+    int64_t numbers[] = {1, 2, 3};
+    data.SetAttribute("numbers", nostd::span<const int64_t>{numbers});
+    key.assign(key.size(), 'x');
+    value.assign(value.size(), 'x');
+    numbers[0] = 4;
+  }
+
+  std::map<std::string, opentelemetry::common::AttributeValue> attributes;
+  data.ForEachAttribute(
+      [&](nostd::string_view key, const opentelemetry::common::AttributeValue &value) {
+        attributes.emplace(std::string(key), value);
+        return true;
+      });
+  ASSERT_EQ(3, attributes.size());
+  EXPECT_EQ("value", nostd::get<nostd::string_view>(attributes["string"]));
+  auto strings = nostd::get<nostd::span<const nostd::string_view>>(attributes["strings"]);
+  ASSERT_EQ(2, strings.size());
+  EXPECT_EQ("value", strings[0]);
+  EXPECT_EQ("other", strings[1]);
+  auto numbers = nostd::get<nostd::span<const int64_t>>(attributes["numbers"]);
+  ASSERT_EQ(3, numbers.size());
+  EXPECT_EQ(1, numbers[0]);
+}
+
+TEST(ArenaSpanData, LastAttributeWriteWins)
+{
+  ArenaSpanData data;
+  data.SetAttribute("attr1", 1);
+  data.SetAttribute("attr2", 2);
+  data.SetAttribute("attr1", 3);
+
+  ASSERT_EQ(2, data.GetAttributeCount());
+  EXPECT_EQ((std::vector<std::string>{"attr1", "attr2"}), GetAttributeKeys(data));
+  data.ForEachAttribute(
+      [](nostd::string_view key, const opentelemetry::common::AttributeValue &value) {
+        EXPECT_EQ(3, nostd::get<int>(value));
+        return false;
+      });
+}
+
+TEST(ArenaSpanData, ManyAttributes)
+{
+  ArenaSpanData data;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; ++i)
+  {
+    keys.push_back("attribute " + std::to_string(i));
+    data.SetAttribute(keys.back(), i);
+  }
+
+  // The attributes no longer fit inline.
+  EXPECT_GT(data.GetArena().GetNumBlocks(), 0);
+  EXPECT_EQ(keys, GetAttributeKeys(data));
+}
+
+TEST(ArenaSpanData, Reset)
+{
+  ArenaSpanData data;
+  data.SetName("span name");
+  for (int i = 0; i < 100; ++i)
+  {
+    data.SetAttribute("attribute " + std::to_string(i), i);
+  }
+  data.Reset();
+
+  ASSERT_EQ(data.GetName(), "");
+  ASSERT_EQ(data.GetAttributeCount(), 0);
+  ASSERT_EQ(data.GetArena().GetNumBlocks(), 0);
+  EXPECT_TRUE(GetAttributeKeys(data).empty());
+}
@@ -0,0 +1,88 @@
+#include "opentelemetry/sdk/trace/attribute_key_table.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::trace::AttributeKeyId;
+using opentelemetry::sdk::trace::AttributeKeyTable;
+
+TEST(AttributeKeyTable, Intern)
+{
+  AttributeKeyTable table;
+  auto method = table.Intern("http.method");
+  auto url    = table.Intern("http.url");
+  EXPECT_EQ(0, method);
+  EXPECT_EQ(1, url);
+  EXPECT_EQ(method, table.Intern(std::string("http.method")));
+  EXPECT_EQ(2, table.size());
+  EXPECT_EQ("http.method", table.GetKey(method));
+  EXPECT_EQ("http.url", table.GetKey(url));
+}
+
+TEST(AttributeKeyTable, Find)
+{
+  AttributeKeyTable table;
+  EXPECT_EQ(AttributeKeyTable::kInvalidKeyId, table.Find("http.method"));
+  EXPECT_EQ(0, table.size());
+
+  auto id = table.Intern("http.method");
+  EXPECT_EQ(id, table.Find("http.method"));
+}
+
+TEST(AttributeKeyTable, EmptyKey)
+{
+  AttributeKeyTable table;
+  auto id = table.Intern("");
+  EXPECT_EQ(0, id);
+  EXPECT_EQ(id, table.Find(""));
+  EXPECT_EQ("", table.GetKey(id));
+}
+
+TEST(AttributeKeyTable, ManyKeys)
+{
+  // Enough keys to fill several chunks and to grow the index several times.
+  const AttributeKeyId n = 3000;
+  AttributeKeyTable table;
+  for (AttributeKeyId i = 0; i < n; ++i)
+  {
+    ASSERT_EQ(i, table.Intern("key " + std::to_string(i)));
+  }
+  for (AttributeKeyId i = 0; i < n; ++i)
+  {
+    EXPECT_EQ(i, table.Find("key " + std::to_string(i)));
+    EXPECT_EQ("key " + std::to_string(i), table.GetKey(i));
+  }
+}
+
+TEST(AttributeKeyTable, ConcurrentIntern)
+{
+  const int num_keys = 2000;
+  AttributeKeyTable table;
+  std::vector<std::vector<AttributeKeyId>> ids(4);
+  std::vector<std::thread> threads;
+  for (auto &thread_ids : ids)
+  {
+    threads.emplace_back([&] {
+      for (int i = 0; i < num_keys; ++i)
+      {
+        auto id = table.Intern("key " + std::to_string(i));
+        EXPECT_EQ("key " + std::to_string(i), table.GetKey(id));
+        thread_ids.push_back(id);
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  // Every thread sees the same id for a key.
+  EXPECT_EQ(num_keys, table.size());
+  for (auto &thread_ids : ids)
+  {
+    EXPECT_EQ(ids[0], thread_ids);
+  }
+}
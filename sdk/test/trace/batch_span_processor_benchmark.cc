@@ -0,0 +1,159 @@
+#include "opentelemetry/sdk/trace/batch_span_processor.h"
+#include "opentelemetry/sdk/trace/simple_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+const int kSpansPerThread = 2000;
+
+// Simulated cost of a single call to an exporter, e.g. for a network round trip.
+const std::chrono::microseconds kExportLatency{10};
+
+/**
+ * An exporter that discards spans after busy-waiting for kExportLatency.
+ */
+class DelayedExporter final : public SpanExporter
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override
+  {
+    auto deadline = std::chrono::steady_clock::now() + kExportLatency;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+    }
+    benchmark::DoNotOptimize(spans.data());
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+};
+
+void EndSpansForThread(SpanProcessor &processor, std::atomic<uint64_t> &on_end_nanoseconds)
+{
+  // Recordables are created up front so that only OnEnd is timed.
+  std::vector<std::unique_ptr<Recordable>> recordables;
+  recordables.reserve(kSpansPerThread);
+  for (int i = 0; i < kSpansPerThread; ++i)
+  {
+    recordables.push_back(processor.MakeRecordable());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto &recordable : recordables)
+  {
+    processor.OnEnd(std::move(recordable));
+  }
+  auto end = std::chrono::steady_clock::now();
+  on_end_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * Ends kSpansPerThread spans on each of state.range(0) threads and reports the
+ * average latency of a single call to OnEnd.
+ */
+void RunOnEndBenchmark(benchmark::State &state, SpanProcessor &processor)
+{
+  auto num_threads = static_cast<int>(state.range(0));
+  std::atomic<uint64_t> on_end_nanoseconds{0};
+  uint64_t num_spans = 0;
+  for (auto _ : state)
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.emplace_back(EndSpansForThread, std::ref(processor), std::ref(on_end_nanoseconds));
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+    num_spans += num_threads * kSpansPerThread;
+  }
+  state.SetItemsProcessed(num_spans);
+  state.counters["OnEnd_ns"] =
+      static_cast<double>(on_end_nanoseconds) / static_cast<double>(num_spans);
+}
+
+void BM_SimpleSpanProcessorOnEnd(benchmark::State &state)
+{
+  SimpleSpanProcessor processor{std::unique_ptr<SpanExporter>(new DelayedExporter)};
+  RunOnEndBenchmark(state, processor);
+}
+
+BENCHMARK(BM_SimpleSpanProcessorOnEnd)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+/**
+ * Runs the batch benchmark for 1 to 64 threads with every backpressure policy,
+ * passed as state.range(1).
+ */
+void BatchSpanProcessorArguments(benchmark::internal::Benchmark *b)
+{
+  for (auto policy : {BackpressurePolicy::kDropNewest, BackpressurePolicy::kDropOldest,
+                      BackpressurePolicy::kBlock})
+  {
+    for (int num_threads = 1; num_threads <= 64; num_threads *= 2)
+    {
+      b->Args({num_threads, static_cast<int>(policy)});
+    }
+  }
+}
+
+void BM_BatchSpanProcessorOnEnd(benchmark::State &state)
+{
+  BatchSpanProcessorOptions options;
+  options.backpressure_policy = static_cast<BackpressurePolicy>(state.range(1));
+  BatchSpanProcessor processor{std::unique_ptr<SpanExporter>(new DelayedExporter), options};
+  RunOnEndBenchmark(state, processor);
+  auto drop_counts                   = processor.GetDropCounts();
+  state.counters["dropped_newest"]   = static_cast<double>(drop_counts.dropped_newest);
+  state.counters["dropped_oldest"]   = static_cast<double>(drop_counts.dropped_oldest);
+  state.counters["dropped_overflow"] = static_cast<double>(drop_counts.dropped_overflow);
+  state.counters["dropped_on_block"] = static_cast<double>(drop_counts.dropped_after_block);
+}
+
+BENCHMARK(BM_BatchSpanProcessorOnEnd)->Apply(BatchSpanProcessorArguments)->UseRealTime();
+
+/**
+ * Ends spans on 8 threads with state.range(1) export workers, so that the drop
+ * counts show how much export throughput additional workers add.
+ */
+void BM_BatchSpanProcessorExportWorkers(benchmark::State &state)
+{
+  std::vector<std::unique_ptr<SpanExporter>> exporters;
+  for (int i = 0; i < state.range(1); ++i)
+  {
+    exporters.emplace_back(new DelayedExporter);
+  }
+  BatchSpanProcessorOptions options;
+  options.max_export_batch_size = 64;
+  BatchSpanProcessor processor{std::move(exporters), options};
+  RunOnEndBenchmark(state, processor);
+  state.counters["dropped"] = static_cast<double>(processor.GetDroppedSpanCount());
+}
+
+BENCHMARK(BM_BatchSpanProcessorExportWorkers)
+    ->Args({8, 1})
+    ->Args({8, 2})
+    ->Args({8, 4})
+    ->UseRealTime();
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,483 @@
+#include "opentelemetry/sdk/trace/batch_span_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace opentelemetry::sdk::trace;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+/**
+ * State shared between a test and its MockSpanExporter.
+ */
+struct MockExporterState
+{
+  std::mutex mu;
+  std::condition_variable cv;
+  std::vector<std::unique_ptr<SpanData>> spans_received;
+  size_t num_batches   = 0;
+  bool is_blocked      = false;
+  bool is_in_export    = false;
+  size_t num_in_export = 0;
+  size_t num_shutdowns = 0;
+
+  /**
+   * Wait until at least n spans were exported.
+   * @return true if n spans were received within the timeout
+   */
+  bool WaitForSpans(size_t n)
+  {
+    std::unique_lock<std::mutex> lock{mu};
+    return cv.wait_for(lock, std::chrono::seconds(10),
+                       [&] { return spans_received.size() >= n; });
+  }
+};
+
+/**
+ * A mock exporter that records the spans it receives. Exports can be blocked
+ * to simulate a slow backend.
+ */
+class MockSpanExporter final : public SpanExporter
+{
+public:
+  explicit MockSpanExporter(std::shared_ptr<MockExporterState> state) noexcept : state_{state} {}
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> &recordables) noexcept override
+  {
+    std::unique_lock<std::mutex> lock{state_->mu};
+    state_->is_in_export = true;
+    ++state_->num_in_export;
+    state_->cv.notify_all();
+    state_->cv.wait_for(lock, std::chrono::seconds(10), [this] { return !state_->is_blocked; });
+    for (auto &recordable : recordables)
+    {
+      auto span = std::unique_ptr<SpanData>(static_cast<SpanData *>(recordable.release()));
+      if (span != nullptr)
+      {
+        state_->spans_received.push_back(std::move(span));
+      }
+    }
+    ++state_->num_batches;
+    state_->is_in_export = --state_->num_in_export > 0;
+    state_->cv.notify_all();
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {
+    std::lock_guard<std::mutex> guard{state_->mu};
+    ++state_->num_shutdowns;
+  }
+
+private:
+  std::shared_ptr<MockExporterState> state_;
+};
+
+std::unique_ptr<SpanExporter> MakeExporter(const std::shared_ptr<MockExporterState> &state)
+{
+  return std::unique_ptr<SpanExporter>(new MockSpanExporter(state));
+}
+
+void EndSpans(SpanProcessor &processor, int n, int first_index = 0)
+{
+  for (int i = first_index; i < first_index + n; ++i)
+  {
+    auto recordable = processor.MakeRecordable();
+    processor.OnStart(*recordable);
+    recordable->SetName("span " + std::to_string(i));
+    processor.OnEnd(std::move(recordable));
+  }
+}
+
+void SetExporterBlocked(MockExporterState &state, bool is_blocked)
+{
+  {
+    std::lock_guard<std::mutex> guard{state.mu};
+    state.is_blocked = is_blocked;
+  }
+  state.cv.notify_all();
+}
+
+/**
+ * Wait until the worker took a batch off the queue and is stuck exporting it.
+ */
+bool WaitForExport(MockExporterState &state)
+{
+  std::unique_lock<std::mutex> lock{state.mu};
+  return state.cv.wait_for(lock, std::chrono::seconds(10), [&] { return state.is_in_export; });
+}
+}  // namespace
+
+TEST(BatchSpanProcessor, ForceFlush)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  EndSpans(processor, 10);
+  processor.ForceFlush();
+
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    ASSERT_EQ(10, state->spans_received.size());
+    for (int i = 0; i < 10; ++i)
+    {
+      EXPECT_EQ("span " + std::to_string(i), state->spans_received[i]->GetName());
+    }
+  }
+
+  processor.ForceFlush();
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(10, state->spans_received.size());
+}
+
+TEST(BatchSpanProcessor, ExportOnFullBatch)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_export_batch_size = 4;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  EndSpans(processor, 4);
+  ASSERT_TRUE(state->WaitForSpans(4));
+}
+
+TEST(BatchSpanProcessor, ExportAfterScheduleDelay)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(10);
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  EndSpans(processor, 3);
+  ASSERT_TRUE(state->WaitForSpans(3));
+}
+
+TEST(BatchSpanProcessor, MaxExportBatchSize)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_export_batch_size = 3;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    state->is_blocked = true;
+  }
+  EndSpans(processor, 10);
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    state->is_blocked = false;
+  }
+  state->cv.notify_all();
+  processor.ForceFlush();
+
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(10, state->spans_received.size());
+  EXPECT_GE(state->num_batches, 4);
+}
+
+TEST(BatchSpanProcessor, DropWhenQueueFull)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 2;
+  options.max_export_batch_size = 2;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    state->is_blocked = true;
+  }
+
+  // The first batch is taken off the queue by the worker, which then blocks in
+  // the exporter.
+  EndSpans(processor, 2);
+  {
+    std::unique_lock<std::mutex> lock{state->mu};
+    ASSERT_TRUE(state->cv.wait_for(lock, std::chrono::seconds(10),
+                                   [&] { return state->is_in_export; }));
+  }
+
+  // The second batch fills the queue, after which spans are dropped.
+  EndSpans(processor, 3);
+  EXPECT_EQ(1, processor.GetDroppedSpanCount());
+  EXPECT_EQ(1, processor.GetDropCounts().dropped_newest);
+
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    state->is_blocked = false;
+  }
+  state->cv.notify_all();
+  processor.Shutdown();
+
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(4, state->spans_received.size());
+}
+
+TEST(BatchSpanProcessor, DropOldestWhenQueueFull)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 2;
+  options.max_export_batch_size = 2;
+  options.backpressure_policy   = BackpressurePolicy::kDropOldest;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 2);
+  ASSERT_TRUE(WaitForExport(*state));
+
+  // Spans 2 and 3 fill the queue, and spans 4 to 6 each replace the oldest
+  // queued span.
+  EndSpans(processor, 5, 2);
+  SetExporterBlocked(*state, false);
+  processor.Shutdown();
+
+  auto drop_counts = processor.GetDropCounts();
+  EXPECT_EQ(3, drop_counts.dropped_oldest);
+  EXPECT_EQ(0, drop_counts.dropped_overflow);
+  EXPECT_EQ(0, drop_counts.dropped_newest);
+  EXPECT_EQ(0, drop_counts.dropped_after_block);
+  EXPECT_EQ(3, processor.GetDroppedSpanCount());
+
+  std::lock_guard<std::mutex> guard{state->mu};
+  ASSERT_EQ(4, state->spans_received.size());
+  EXPECT_EQ("span 0", state->spans_received[0]->GetName());
+  EXPECT_EQ("span 1", state->spans_received[1]->GetName());
+  EXPECT_EQ("span 5", state->spans_received[2]->GetName());
+  EXPECT_EQ("span 6", state->spans_received[3]->GetName());
+}
+
+TEST(BatchSpanProcessor, DropOldestExportsInOrder)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 4;
+  options.max_export_batch_size = 2;
+  options.backpressure_policy   = BackpressurePolicy::kDropOldest;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 2);
+  ASSERT_TRUE(WaitForExport(*state));
+
+  // Spans 2 to 5 fill the queue, and spans 6 and 7 evict spans 2 and 3. The
+  // remaining spans are still exported in the order they ended.
+  EndSpans(processor, 6, 2);
+  SetExporterBlocked(*state, false);
+  processor.Shutdown();
+
+  EXPECT_EQ(2, processor.GetDropCounts().dropped_oldest);
+  std::lock_guard<std::mutex> guard{state->mu};
+  ASSERT_EQ(6, state->spans_received.size());
+  const char *expected_names[] = {"span 0", "span 1", "span 4", "span 5", "span 6", "span 7"};
+  for (size_t i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(expected_names[i], state->spans_received[i]->GetName());
+  }
+}
+
+TEST(BatchSpanProcessor, DropOldestFromFullShard)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 4;
+  options.max_export_batch_size = 2;
+  options.num_queue_shards      = 2;
+  options.backpressure_policy   = BackpressurePolicy::kDropOldest;
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 2);
+  ASSERT_TRUE(WaitForExport(*state));
+
+  // A single thread only fills its own shard, which holds two spans, so spans
+  // 4 and 5 evict spans 2 and 3 although the other shard is empty.
+  EndSpans(processor, 4, 2);
+  SetExporterBlocked(*state, false);
+  processor.Shutdown();
+
+  EXPECT_EQ(2, processor.GetDropCounts().dropped_oldest);
+  std::lock_guard<std::mutex> guard{state->mu};
+  ASSERT_EQ(4, state->spans_received.size());
+  const char *expected_names[] = {"span 0", "span 1", "span 4", "span 5"};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(expected_names[i], state->spans_received[i]->GetName());
+  }
+}
+
+TEST(BatchSpanProcessor, BlockWhenQueueFull)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 2;
+  options.max_export_batch_size = 2;
+  options.backpressure_policy   = BackpressurePolicy::kBlock;
+  options.max_block_time        = std::chrono::milliseconds(20);
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 2);
+  ASSERT_TRUE(WaitForExport(*state));
+
+  // The queue stays full while the exporter is blocked, so the last span is
+  // dropped once max_block_time has passed.
+  EndSpans(processor, 3, 2);
+  auto drop_counts = processor.GetDropCounts();
+  EXPECT_EQ(1, drop_counts.dropped_after_block);
+  EXPECT_EQ(0, drop_counts.dropped_newest);
+  EXPECT_EQ(0, drop_counts.dropped_oldest);
+
+  SetExporterBlocked(*state, false);
+  processor.Shutdown();
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(4, state->spans_received.size());
+}
+
+TEST(BatchSpanProcessor, BlockUntilQueueHasRoom)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_queue_size        = 2;
+  options.max_export_batch_size = 2;
+  options.backpressure_policy   = BackpressurePolicy::kBlock;
+  options.max_block_time        = std::chrono::seconds(10);
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 2);
+  ASSERT_TRUE(WaitForExport(*state));
+
+  std::thread producer{EndSpans, std::ref(processor), 10, 2};
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  SetExporterBlocked(*state, false);
+  producer.join();
+  processor.Shutdown();
+
+  EXPECT_EQ(0, processor.GetDroppedSpanCount());
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(12, state->spans_received.size());
+}
+
+TEST(BatchSpanProcessor, Shutdown)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  BatchSpanProcessor processor(MakeExporter(state), options);
+
+  EndSpans(processor, 5);
+  processor.Shutdown();
+
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    EXPECT_EQ(5, state->spans_received.size());
+    EXPECT_EQ(1, state->num_shutdowns);
+  }
+
+  // Spans ended after shutdown are dropped.
+  EndSpans(processor, 1);
+  processor.ForceFlush();
+  processor.Shutdown();
+  EXPECT_EQ(1, processor.GetDropCounts().dropped_after_shutdown);
+  EXPECT_EQ(1, processor.GetDroppedSpanCount());
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(5, state->spans_received.size());
+}
+
+TEST(BatchSpanProcessor, ConcurrentProducers)
+{
+  for (size_t num_queue_shards : {1, 4})
+  {
+    std::shared_ptr<MockExporterState> state(new MockExporterState);
+    BatchSpanProcessorOptions options;
+    options.schedule_delay_millis = std::chrono::milliseconds(1);
+    options.max_queue_size        = 100000;
+    options.num_queue_shards      = num_queue_shards;
+    BatchSpanProcessor processor(MakeExporter(state), options);
+
+    const int num_threads = 4;
+    const int n           = 1000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.emplace_back(EndSpans, std::ref(processor), n, 0);
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+    processor.Shutdown();
+
+    std::lock_guard<std::mutex> guard{state->mu};
+    EXPECT_EQ(num_threads * n, state->spans_received.size());
+    EXPECT_EQ(0, processor.GetDroppedSpanCount());
+  }
+}
+
+TEST(BatchSpanProcessor, ParallelExport)
+{
+  std::shared_ptr<MockExporterState> state(new MockExporterState);
+  BatchSpanProcessorOptions options;
+  options.schedule_delay_millis = std::chrono::milliseconds(60 * 60 * 1000);
+  options.max_export_batch_size = 2;
+  std::vector<std::unique_ptr<SpanExporter>> exporters;
+  for (int i = 0; i < 3; ++i)
+  {
+    exporters.push_back(MakeExporter(state));
+  }
+  BatchSpanProcessor processor(std::move(exporters), options);
+
+  // While one worker is stuck exporting, the others keep taking batches off
+  // the queue.
+  SetExporterBlocked(*state, true);
+  EndSpans(processor, 6);
+  {
+    std::unique_lock<std::mutex> lock{state->mu};
+    EXPECT_TRUE(state->cv.wait_for(lock, std::chrono::seconds(10),
+                                   [&] { return state->num_in_export == 3; }));
+  }
+  SetExporterBlocked(*state, false);
+
+  EndSpans(processor, 100, 6);
+  processor.ForceFlush();
+  {
+    std::lock_guard<std::mutex> guard{state->mu};
+    ASSERT_EQ(106, state->spans_received.size());
+    std::vector<std::string> names;
+    for (auto &span : state->spans_received)
+    {
+      names.push_back(std::string(span->GetName()));
+    }
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names.end(), std::unique(names.begin(), names.end()));
+  }
+
+  processor.Shutdown();
+  std::lock_guard<std::mutex> guard{state->mu};
+  EXPECT_EQ(3, state->num_shutdowns);
+}
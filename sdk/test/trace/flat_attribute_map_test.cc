@@ -0,0 +1,90 @@
+#include "opentelemetry/sdk/trace/flat_attribute_map.h"
+#include "opentelemetry/nostd/variant.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::trace::FlatAttributeMap;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+std::vector<std::string> GetKeys(const FlatAttributeMap &map)
+{
+  std::vector<std::string> result;
+  for (auto &entry : map)
+  {
+    result.push_back(std::string(entry.GetKey()));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(FlatAttributeMap, SetAndFind)
+{
+  FlatAttributeMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find("attr1"));
+
+  map.Set("attr1", 1);
+  map.Set("attr2", nostd::string_view{"value"});
+  ASSERT_EQ(2, map.size());
+  ASSERT_NE(nullptr, map.Find("attr1"));
+  EXPECT_EQ(1, nostd::get<int>(map.Find("attr1")->Get()));
+  EXPECT_EQ("value", nostd::get<nostd::string_view>(map.Find("attr2")->Get()));
+  EXPECT_EQ(nullptr, map.Find("attr3"));
+}
+
+TEST(FlatAttributeMap, LastWriteWins)
+{
+  FlatAttributeMap map;
+  map.Set("attr1", 1);
+  map.Set("attr2", 2);
+  map.Set("attr1", 3);
+
+  ASSERT_EQ(2, map.size());
+  EXPECT_EQ((std::vector<std::string>{"attr1", "attr2"}), GetKeys(map));
+  EXPECT_EQ(3, nostd::get<int>(map.Find("attr1")->Get()));
+}
+
+TEST(FlatAttributeMap, ManyAttributes)
+{
+  FlatAttributeMap map;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; ++i)
+  {
+    keys.push_back("attribute " + std::to_string(i));
+    map.Set(keys.back(), i);
+  }
+  for (int i = 0; i < 100; i += 2)
+  {
+    map.Set(keys[i], -i);
+  }
+
+  ASSERT_EQ(100, map.size());
+  EXPECT_EQ(keys, GetKeys(map));
+  for (int i = 0; i < 100; ++i)
+  {
+    ASSERT_NE(nullptr, map.Find(keys[i]));
+    EXPECT_EQ(i % 2 == 0 ? -i : i, nostd::get<int>(map.Find(keys[i])->Get()));
+  }
+  EXPECT_EQ(nullptr, map.Find("attribute 100"));
+}
+
+TEST(FlatAttributeMap, Clear)
+{
+  FlatAttributeMap map;
+  for (int i = 0; i < 20; ++i)
+  {
+    map.Set("attribute " + std::to_string(i), i);
+  }
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find("attribute 1"));
+
+  map.Set("attribute 1", 1);
+  ASSERT_EQ(1, map.size());
+  EXPECT_EQ(1, nostd::get<int>(map.Find("attribute 1")->Get()));
+}
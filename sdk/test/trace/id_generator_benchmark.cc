@@ -0,0 +1,93 @@
+#include "opentelemetry/sdk/trace/random_id_generator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __unix__
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+RandomIdGenerator id_generator;
+
+void BM_RandomIdGeneratorSpanId(benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(id_generator.GenerateSpanId());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RandomIdGeneratorSpanId)->ThreadRange(1, 64);
+
+void BM_RandomIdGeneratorTraceId(benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(id_generator.GenerateTraceId());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RandomIdGeneratorTraceId)->ThreadRange(1, 64);
+
+#ifdef __unix__
+uint64_t ToInteger(const trace_api::SpanId &span_id)
+{
+  uint64_t result;
+  std::memcpy(&result, span_id.Id().data(), sizeof(result));
+  return result;
+}
+
+/**
+ * Forks once per iteration and checks that the child doesn't generate the
+ * same span id as the parent, i.e. that the pool inherited from the parent is
+ * discarded through the fork handler.
+ */
+void BM_RandomIdGeneratorAfterFork(benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    id_generator.GenerateSpanId();
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+      state.SkipWithError("pipe failed");
+      break;
+    }
+    auto pid = fork();
+    if (pid == -1)
+    {
+      state.SkipWithError("fork failed");
+      break;
+    }
+    if (pid == 0)
+    {
+      uint64_t child_id = ToInteger(id_generator.GenerateSpanId());
+      auto written      = write(fds[1], &child_id, sizeof(child_id));
+      _exit(written == sizeof(child_id) ? 0 : 1);
+    }
+    uint64_t parent_id = ToInteger(id_generator.GenerateSpanId());
+    uint64_t child_id  = 0;
+    auto num_read      = read(fds[0], &child_id, sizeof(child_id));
+    waitpid(pid, nullptr, 0);
+    close(fds[0]);
+    close(fds[1]);
+    if (num_read != sizeof(child_id) || parent_id == child_id)
+    {
+      state.SkipWithError("child generated the same span id as the parent");
+      break;
+    }
+  }
+}
+BENCHMARK(BM_RandomIdGeneratorAfterFork);
+#endif
+}  // namespace
+BENCHMARK_MAIN();
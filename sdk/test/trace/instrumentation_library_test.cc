@@ -0,0 +1,28 @@
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::trace::InstrumentationLibrary;
+
+TEST(InstrumentationLibrary, Get)
+{
+  auto &library = InstrumentationLibrary::Get("test", "1.0.0");
+  EXPECT_EQ("test", library.GetName());
+  EXPECT_EQ("1.0.0", library.GetVersion());
+
+  auto &unversioned = InstrumentationLibrary::Get("test");
+  EXPECT_EQ("test", unversioned.GetName());
+  EXPECT_EQ("", unversioned.GetVersion());
+}
+
+TEST(InstrumentationLibrary, Interned)
+{
+  std::string name{"interned"};
+  auto &library = InstrumentationLibrary::Get(name, "1.0.0");
+  name          = "modified";
+  EXPECT_EQ(&library, &InstrumentationLibrary::Get("interned", "1.0.0"));
+  EXPECT_EQ("interned", library.GetName());
+
+  EXPECT_NE(&library, &InstrumentationLibrary::Get("interned", "2.0.0"));
+  EXPECT_NE(&library, &InstrumentationLibrary::Get("interned"));
+}
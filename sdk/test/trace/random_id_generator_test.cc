@@ -0,0 +1,110 @@
+#include "opentelemetry/sdk/trace/random_id_generator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+uint64_t ToInteger(const trace_api::SpanId &span_id)
+{
+  uint64_t result;
+  std::memcpy(&result, span_id.Id().data(), sizeof(result));
+  return result;
+}
+}  // namespace
+
+TEST(RandomIdGenerator, GeneratesValidIds)
+{
+  RandomIdGenerator id_generator;
+  for (int i = 0; i < 1000; ++i)
+  {
+    ASSERT_TRUE(id_generator.GenerateTraceId().IsValid());
+    ASSERT_TRUE(id_generator.GenerateSpanId().IsValid());
+  }
+}
+
+TEST(RandomIdGenerator, GeneratesDistinctIds)
+{
+  RandomIdGenerator id_generator;
+  std::set<uint64_t> span_ids;
+  std::set<std::string> trace_ids;
+  const int num_ids = 1000;
+  for (int i = 0; i < num_ids; ++i)
+  {
+    span_ids.insert(ToInteger(id_generator.GenerateSpanId()));
+    auto trace_id = id_generator.GenerateTraceId().Id();
+    trace_ids.emplace(reinterpret_cast<const char *>(trace_id.data()), trace_id.size());
+  }
+  ASSERT_EQ(num_ids, span_ids.size());
+  ASSERT_EQ(num_ids, trace_ids.size());
+}
+
+TEST(RandomIdGenerator, GeneratesDistinctIdsAcrossThreads)
+{
+  RandomIdGenerator id_generator;
+  const int num_threads    = 8;
+  const int ids_per_thread = 1000;
+  std::mutex mutex;
+  std::set<uint64_t> span_ids;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back([&] {
+      std::vector<uint64_t> ids;
+      for (int j = 0; j < ids_per_thread; ++j)
+      {
+        ids.push_back(ToInteger(id_generator.GenerateSpanId()));
+      }
+      std::lock_guard<std::mutex> guard{mutex};
+      span_ids.insert(ids.begin(), ids.end());
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  ASSERT_EQ(num_threads * ids_per_thread, span_ids.size());
+}
+
+#ifdef __unix__
+TEST(RandomIdGenerator, GeneratesDistinctIdsAfterFork)
+{
+  RandomIdGenerator id_generator;
+  // Fill this thread's pool, so that the child inherits the remaining ids.
+  id_generator.GenerateSpanId();
+
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  auto pid = fork();
+  ASSERT_NE(-1, pid);
+  if (pid == 0)
+  {
+    uint64_t child_id = ToInteger(id_generator.GenerateSpanId());
+    auto written      = write(fds[1], &child_id, sizeof(child_id));
+    _exit(written == sizeof(child_id) ? 0 : 1);
+  }
+  uint64_t parent_id = ToInteger(id_generator.GenerateSpanId());
+  uint64_t child_id  = 0;
+  ASSERT_EQ(sizeof(child_id), read(fds[0], &child_id, sizeof(child_id)));
+  waitpid(pid, nullptr, 0);
+  close(fds[0]);
+  close(fds[1]);
+  ASSERT_NE(parent_id, child_id);
+}
+#endif
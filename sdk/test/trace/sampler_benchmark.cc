@@ -0,0 +1,261 @@
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/samplers/parent_based.h"
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+#include "opentelemetry/trace/key_value_iterable_view.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+std::atomic<size_t> num_allocations{0};
+}  // namespace
+
+// Count heap allocations, so that benchmarks can report them per decision.
+void *operator new(size_t size)
+{
+  ++num_allocations;
+  auto result = std::malloc(size == 0 ? 1 : size);
+  if (result == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  ++num_allocations;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+/**
+ * Reports the number of heap allocations per iteration since it was created.
+ */
+class AllocationCounter
+{
+public:
+  explicit AllocationCounter(benchmark::State &state) noexcept
+      : state_(state), start_{num_allocations.load()}
+  {}
+
+  ~AllocationCounter()
+  {
+    state_.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(num_allocations.load() - start_), benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  benchmark::State &state_;
+  size_t start_;
+};
+
+/**
+ * Asks sampler for a decision on spans of varying trace ids.
+ */
+void RunShouldSample(benchmark::State &state,
+                     Sampler &sampler,
+                     const trace_api::SpanContext *parent_context = nullptr,
+                     opentelemetry::nostd::string_view name       = "span")
+{
+  std::map<std::string, int> attributes;
+  trace_api::KeyValueIterableView<std::map<std::string, int>> attributes_view{attributes};
+  uint8_t trace_id[trace_api::TraceId::kSize] = {1};
+  AllocationCounter allocation_counter{state};
+  for (auto _ : state)
+  {
+    ++trace_id[trace_api::TraceId::kSize - 1];
+    auto result = sampler.ShouldSample(parent_context, trace_api::TraceId{trace_id}, name,
+                                       trace_api::SpanKind::kInternal, attributes_view);
+    benchmark::DoNotOptimize(result.decision);
+  }
+}
+
+void BM_AlwaysOnSampler(benchmark::State &state)
+{
+  AlwaysOnSampler sampler;
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_AlwaysOnSampler);
+
+void BM_AlwaysOffSampler(benchmark::State &state)
+{
+  AlwaysOffSampler sampler;
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_AlwaysOffSampler);
+
+void BM_TraceIdRatioBasedSampler(benchmark::State &state)
+{
+  TraceIdRatioBasedSampler sampler{0.5};
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_TraceIdRatioBasedSampler);
+
+void BM_ParentBasedSamplerWithParent(benchmark::State &state)
+{
+  ParentBasedSampler sampler{std::make_shared<TraceIdRatioBasedSampler>(0.5)};
+  uint8_t trace_id[trace_api::TraceId::kSize] = {1};
+  uint8_t span_id[trace_api::SpanId::kSize]   = {1};
+  trace_api::SpanContext parent_context{trace_api::TraceId{trace_id}, trace_api::SpanId{span_id},
+                                        trace_api::TraceFlags{trace_api::TraceFlags::kIsSampled}};
+  RunShouldSample(state, sampler, &parent_context);
+}
+
+BENCHMARK(BM_ParentBasedSamplerWithParent);
+
+void BM_ParentBasedSamplerWithoutParent(benchmark::State &state)
+{
+  ParentBasedSampler sampler{std::make_shared<TraceIdRatioBasedSampler>(0.5)};
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_ParentBasedSamplerWithoutParent);
+
+/**
+ * Shares a RateLimitingSampler of 2000 spans per second among the benchmark
+ * threads. Its cost per decision should stay flat as threads are added.
+ */
+void BM_RateLimitingSampler(benchmark::State &state)
+{
+  static RateLimitingSampler sampler{2000};
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_RateLimitingSampler)->ThreadRange(1, 64)->UseRealTime();
+
+/**
+ * Makes a RuleBasedSampler with state.range(0) rules for distinct operations,
+ * followed by rules for health checks, checkout and a 5% default, and asks it
+ * about checkout spans.
+ */
+void BM_RuleBasedSampler(benchmark::State &state)
+{
+  std::vector<SamplingRule> rules;
+  for (int64_t i = 0; i < state.range(0); ++i)
+  {
+    SamplingRule rule;
+    rule.name    = "/api/v1/operation" + std::to_string(i);
+    rule.sampler = std::make_shared<AlwaysOnSampler>();
+    rules.push_back(std::move(rule));
+  }
+  SamplingRule health_rule;
+  health_rule.name      = "/health";
+  health_rule.is_prefix = true;
+  health_rule.sampler   = std::make_shared<AlwaysOffSampler>();
+  rules.push_back(std::move(health_rule));
+  SamplingRule checkout_rule;
+  checkout_rule.name    = "/api/v1/checkout";
+  checkout_rule.sampler = std::make_shared<AlwaysOnSampler>();
+  rules.push_back(std::move(checkout_rule));
+  RuleBasedSampler sampler{std::move(rules), std::make_shared<TraceIdRatioBasedSampler>(0.05)};
+  RunShouldSample(state, sampler, nullptr, "/api/v1/checkout");
+}
+
+BENCHMARK(BM_RuleBasedSampler)->Arg(0)->Arg(10)->Arg(1000);
+
+AdaptiveSamplerOptions MakeAdaptiveSamplerOptions(double target_spans_per_second,
+                                                  std::chrono::milliseconds adjustment_interval)
+{
+  AdaptiveSamplerOptions options;
+  options.target_spans_per_second = target_spans_per_second;
+  options.adjustment_interval     = adjustment_interval;
+  return options;
+}
+
+/**
+ * Shares an AdaptiveSampler that adjusts its ratio every 10ms among the
+ * benchmark threads.
+ */
+void BM_AdaptiveSampler(benchmark::State &state)
+{
+  static AdaptiveSampler sampler{MakeAdaptiveSamplerOptions(2000, std::chrono::milliseconds(10))};
+  RunShouldSample(state, sampler);
+}
+
+BENCHMARK(BM_AdaptiveSampler)->ThreadRange(1, 64)->UseRealTime();
+
+/**
+ * Simulates 10 seconds of state.range(0) spans per second, followed by 10
+ * seconds of state.range(1) spans per second, with an AdaptiveSampler
+ * targeting 1000 spans per second. Reports the spans sampled in each
+ * simulated second, to show how quickly the sampler converges.
+ */
+void BM_AdaptiveSamplerConvergence(benchmark::State &state)
+{
+  std::map<std::string, int> attributes;
+  trace_api::KeyValueIterableView<std::map<std::string, int>> attributes_view{attributes};
+  std::vector<int64_t> num_sampled;
+  for (auto _ : state)
+  {
+    AdaptiveSampler sampler{MakeAdaptiveSamplerOptions(1000, std::chrono::milliseconds(0))};
+    num_sampled.clear();
+    for (int second = 0; second < 20; ++second)
+    {
+      auto num_spans = state.range(second < 10 ? 0 : 1);
+      int64_t count  = 0;
+      for (int64_t i = 0; i < num_spans; ++i)
+      {
+        // Trace ids are random, so the low bits are spread evenly.
+        uint64_t low_bits = static_cast<uint64_t>(i) * (UINT64_MAX / num_spans);
+        uint8_t trace_id[trace_api::TraceId::kSize] = {1};
+        for (int j = trace_api::TraceId::kSize - 1; j >= trace_api::TraceId::kSize - 8; --j)
+        {
+          trace_id[j] = static_cast<uint8_t>(low_bits);
+          low_bits >>= 8;
+        }
+        auto result = sampler.ShouldSample(nullptr, trace_api::TraceId{trace_id}, "span",
+                                           trace_api::SpanKind::kInternal, attributes_view);
+        count += result.decision == Decision::RECORD_AND_SAMPLE;
+      }
+      sampler.AdjustRatio(std::chrono::seconds(1));
+      num_sampled.push_back(count);
+    }
+  }
+  for (size_t second = 0; second < num_sampled.size(); ++second)
+  {
+    char name[32];
+    std::snprintf(name, sizeof(name), "second_%02zu", second);
+    state.counters[name] = static_cast<double>(num_sampled[second]);
+  }
+}
+
+BENCHMARK(BM_AdaptiveSamplerConvergence)
+    ->Args({10000, 100000})
+    ->Args({100000, 10000})
+    ->Args({100000, 500})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,374 @@
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/samplers/parent_based.h"
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+#include "opentelemetry/trace/key_value_iterable_view.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+namespace nostd     = opentelemetry::nostd;
+
+namespace
+{
+const std::map<std::string, int> kNoAttributes;
+const trace_api::KeyValueIterableView<std::map<std::string, int>> kNoAttributesView{kNoAttributes};
+
+/**
+ * @return a TraceId whose last 8 bytes are low_bits, in big-endian order.
+ */
+trace_api::TraceId MakeTraceId(uint64_t low_bits)
+{
+  uint8_t buffer[trace_api::TraceId::kSize] = {1};
+  for (int i = trace_api::TraceId::kSize - 1; i >= trace_api::TraceId::kSize - 8; --i)
+  {
+    buffer[i] = static_cast<uint8_t>(low_bits);
+    low_bits >>= 8;
+  }
+  return trace_api::TraceId{buffer};
+}
+
+trace_api::SpanContext MakeSpanContext(bool sampled)
+{
+  uint8_t span_id[trace_api::SpanId::kSize] = {1};
+  return trace_api::SpanContext{MakeTraceId(1), trace_api::SpanId{span_id},
+                                trace_api::TraceFlags{sampled ? trace_api::TraceFlags::kIsSampled
+                                                              : uint8_t{0}}};
+}
+
+Decision Sample(Sampler &sampler,
+                trace_api::TraceId trace_id,
+                const trace_api::SpanContext *parent_context = nullptr)
+{
+  auto result = sampler.ShouldSample(parent_context, trace_id, "span",
+                                     trace_api::SpanKind::kInternal, kNoAttributesView);
+  EXPECT_EQ(result.attributes, nullptr);
+  return result.decision;
+}
+}  // namespace
+
+TEST(AlwaysOnSampler, ShouldSample)
+{
+  AlwaysOnSampler sampler;
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(0)));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(UINT64_MAX)));
+  EXPECT_EQ("AlwaysOnSampler", sampler.GetDescription());
+}
+
+TEST(AlwaysOffSampler, ShouldSample)
+{
+  AlwaysOffSampler sampler;
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(0)));
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(UINT64_MAX)));
+  EXPECT_EQ("AlwaysOffSampler", sampler.GetDescription());
+}
+
+TEST(TraceIdRatioBasedSampler, UsesLowTraceIdBits)
+{
+  TraceIdRatioBasedSampler sampler{0.5};
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(0)));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId((uint64_t{1} << 63) - 1)));
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(uint64_t{1} << 63)));
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(UINT64_MAX)));
+  EXPECT_EQ("TraceIdRatioBasedSampler{0.500000}", sampler.GetDescription());
+}
+
+TEST(TraceIdRatioBasedSampler, ClampsRatio)
+{
+  TraceIdRatioBasedSampler never{-1.0};
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(never, MakeTraceId(0)));
+  EXPECT_EQ("TraceIdRatioBasedSampler{0.000000}", never.GetDescription());
+
+  TraceIdRatioBasedSampler always{2.0};
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(always, MakeTraceId(UINT64_MAX)));
+  EXPECT_EQ("TraceIdRatioBasedSampler{1.000000}", always.GetDescription());
+}
+
+TEST(TraceIdRatioBasedSampler, SamplesRatio)
+{
+  TraceIdRatioBasedSampler sampler{0.25};
+  const int num_traces = 10000;
+  int num_sampled      = 0;
+  // Spread the low bits over the whole range.
+  const uint64_t step = UINT64_MAX / num_traces;
+  for (int i = 0; i < num_traces; ++i)
+  {
+    if (Sample(sampler, MakeTraceId(i * step)) == Decision::RECORD_AND_SAMPLE)
+    {
+      ++num_sampled;
+    }
+  }
+  EXPECT_NEAR(num_traces / 4, num_sampled, 1);
+}
+
+TEST(ParentBasedSampler, FollowsParent)
+{
+  ParentBasedSampler sampler{std::make_shared<AlwaysOffSampler>()};
+  auto sampled_parent   = MakeSpanContext(true);
+  auto unsampled_parent = MakeSpanContext(false);
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(1), &sampled_parent));
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(1), &unsampled_parent));
+}
+
+TEST(ParentBasedSampler, DelegatesRootSpans)
+{
+  ParentBasedSampler sampler{std::make_shared<AlwaysOnSampler>()};
+  trace_api::SpanContext invalid_parent;
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(1)));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(1), &invalid_parent));
+  EXPECT_EQ("ParentBased{AlwaysOnSampler}", sampler.GetDescription());
+}
+
+TEST(RateLimitingSampler, SamplesBurst)
+{
+  RateLimitingSampler sampler{100};
+  auto start      = std::chrono::steady_clock::now();
+  int num_sampled = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (Sample(sampler, MakeTraceId(i)) == Decision::RECORD_AND_SAMPLE)
+    {
+      ++num_sampled;
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // A full bucket holds a second's worth of spans, and it refills while the
+  // loop runs.
+  EXPECT_LE(100, num_sampled);
+  EXPECT_GE(100 + 100 * std::chrono::duration<double>(elapsed).count() + 1, num_sampled);
+  EXPECT_EQ("RateLimitingSampler{100.000000}", sampler.GetDescription());
+}
+
+TEST(RateLimitingSampler, Refills)
+{
+  RateLimitingSampler sampler{1000};
+  while (Sample(sampler, MakeTraceId(1)) == Decision::RECORD_AND_SAMPLE)
+  {}
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, Sample(sampler, MakeTraceId(1)));
+}
+
+TEST(RateLimitingSampler, ZeroRate)
+{
+  RateLimitingSampler sampler{0};
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(sampler, MakeTraceId(1)));
+  RateLimitingSampler negative{-1};
+  EXPECT_EQ(Decision::NOT_RECORD, Sample(negative, MakeTraceId(1)));
+}
+
+TEST(RateLimitingSampler, Concurrent)
+{
+  RateLimitingSampler sampler{1000};
+  const int num_threads = 8;
+  std::atomic<int> num_sampled{0};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 10000; ++j)
+      {
+        if (Sample(sampler, MakeTraceId(j)) == Decision::RECORD_AND_SAMPLE)
+        {
+          ++num_sampled;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LE(1000, num_sampled);
+  EXPECT_GE(1000 + 1000 * std::chrono::duration<double>(elapsed).count() + 1, num_sampled);
+}
+
+namespace
+{
+/**
+ * Simulate a second of spans with trace ids spread over the whole range.
+ * @return the number of sampled spans
+ */
+int SampleSecond(AdaptiveSampler &sampler, int num_spans)
+{
+  int num_sampled     = 0;
+  const uint64_t step = UINT64_MAX / num_spans;
+  for (int i = 0; i < num_spans; ++i)
+  {
+    if (Sample(sampler, MakeTraceId(i * step)) == Decision::RECORD_AND_SAMPLE)
+    {
+      ++num_sampled;
+    }
+  }
+  sampler.AdjustRatio(std::chrono::seconds(1));
+  return num_sampled;
+}
+}  // namespace
+
+TEST(AdaptiveSampler, ConvergesToTarget)
+{
+  AdaptiveSamplerOptions options;
+  options.target_spans_per_second = 100;
+  options.adjustment_interval     = std::chrono::milliseconds(0);
+  options.smoothing               = 1.0;
+  AdaptiveSampler sampler{options};
+  EXPECT_EQ(1.0, sampler.GetRatio());
+  EXPECT_EQ("AdaptiveSampler{100.000000}", sampler.GetDescription());
+
+  EXPECT_EQ(10000, SampleSecond(sampler, 10000));
+  EXPECT_DOUBLE_EQ(0.01, sampler.GetRatio());
+  EXPECT_NEAR(100, SampleSecond(sampler, 10000), 1);
+
+  // The load rises tenfold.
+  SampleSecond(sampler, 100000);
+  EXPECT_DOUBLE_EQ(0.001, sampler.GetRatio());
+  EXPECT_NEAR(100, SampleSecond(sampler, 100000), 1);
+
+  // The load falls below the target.
+  SampleSecond(sampler, 50);
+  EXPECT_EQ(1.0, sampler.GetRatio());
+  EXPECT_EQ(50, SampleSecond(sampler, 50));
+}
+
+TEST(AdaptiveSampler, SmoothsRate)
+{
+  AdaptiveSamplerOptions options;
+  options.target_spans_per_second = 100;
+  options.adjustment_interval     = std::chrono::milliseconds(0);
+  options.smoothing               = 0.5;
+  AdaptiveSampler sampler{options};
+
+  SampleSecond(sampler, 1000);
+  EXPECT_DOUBLE_EQ(0.1, sampler.GetRatio());
+  // A spike is averaged with the previous rate.
+  SampleSecond(sampler, 3000);
+  EXPECT_DOUBLE_EQ(0.05, sampler.GetRatio());
+}
+
+TEST(AdaptiveSampler, AdjustsOnWorkerThread)
+{
+  AdaptiveSamplerOptions options;
+  options.target_spans_per_second = 1;
+  options.adjustment_interval     = std::chrono::milliseconds(10);
+  AdaptiveSampler sampler{options};
+
+  for (int i = 0; i < 1000 && sampler.GetRatio() == 1.0; ++i)
+  {
+    for (int j = 0; j < 100; ++j)
+    {
+      Sample(sampler, MakeTraceId(j));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GT(1.0, sampler.GetRatio());
+}
+
+namespace
+{
+SamplingRule MakeRule(std::string name, bool is_prefix, std::shared_ptr<Sampler> sampler)
+{
+  SamplingRule rule;
+  rule.name      = std::move(name);
+  rule.is_prefix = is_prefix;
+  rule.sampler   = std::move(sampler);
+  return rule;
+}
+
+template <class T = std::map<std::string, int>>
+Decision SampleSpan(Sampler &sampler,
+                    nostd::string_view name,
+                    trace_api::SpanKind span_kind = trace_api::SpanKind::kInternal,
+                    const T &attributes           = {})
+{
+  return sampler
+      .ShouldSample(nullptr, MakeTraceId(1), name, span_kind,
+                    trace_api::KeyValueIterableView<T>{attributes})
+      .decision;
+}
+}  // namespace
+
+TEST(RuleBasedSampler, MatchesNames)
+{
+  auto on  = std::make_shared<AlwaysOnSampler>();
+  auto off = std::make_shared<AlwaysOffSampler>();
+  std::vector<SamplingRule> rules;
+  rules.push_back(MakeRule("/health", false, off));
+  rules.push_back(MakeRule("/checkout", true, on));
+  rules.push_back(MakeRule("/check", false, off));
+  RuleBasedSampler sampler{std::move(rules), on};
+
+  EXPECT_EQ(Decision::NOT_RECORD, SampleSpan(sampler, "/health"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/healthz"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/health/"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/checkout"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/checkout/cart"));
+  EXPECT_EQ(Decision::NOT_RECORD, SampleSpan(sampler, "/check"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, ""));
+  EXPECT_EQ("RuleBasedSampler{3 rules, default=AlwaysOnSampler}", sampler.GetDescription());
+}
+
+TEST(RuleBasedSampler, FirstRuleWins)
+{
+  auto on  = std::make_shared<AlwaysOnSampler>();
+  auto off = std::make_shared<AlwaysOffSampler>();
+  std::vector<SamplingRule> rules;
+  rules.push_back(MakeRule("/api/v1", false, on));
+  rules.push_back(MakeRule("/api", true, off));
+  rules.push_back(MakeRule("/api/v2", false, on));
+  rules.push_back(MakeRule("", true, on));
+  RuleBasedSampler sampler{std::move(rules), off};
+
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/api/v1"));
+  EXPECT_EQ(Decision::NOT_RECORD, SampleSpan(sampler, "/api/v2"));
+  EXPECT_EQ(Decision::NOT_RECORD, SampleSpan(sampler, "/api"));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "/other"));
+}
+
+TEST(RuleBasedSampler, MatchesSpanKindAndAttributes)
+{
+  auto on  = std::make_shared<AlwaysOnSampler>();
+  auto off = std::make_shared<AlwaysOffSampler>();
+  std::vector<SamplingRule> rules;
+
+  auto server_rule            = MakeRule("", true, off);
+  server_rule.match_span_kind = true;
+  server_rule.span_kind       = trace_api::SpanKind::kServer;
+  rules.push_back(server_rule);
+
+  auto attribute_rule = MakeRule("query", false, off);
+  attribute_rule.attributes.emplace_back("db.system", nostd::string_view{"redis"});
+  attribute_rule.attributes.emplace_back("db.index", 3);
+  rules.push_back(attribute_rule);
+  RuleBasedSampler sampler{std::move(rules), on};
+
+  EXPECT_EQ(Decision::NOT_RECORD, SampleSpan(sampler, "query", trace_api::SpanKind::kServer));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE, SampleSpan(sampler, "query", trace_api::SpanKind::kClient));
+
+  std::map<std::string, opentelemetry::common::AttributeValue> redis = {
+      {"db.system", nostd::string_view{"redis"}}, {"db.index", 3}};
+  std::map<std::string, opentelemetry::common::AttributeValue> postgres = {
+      {"db.system", nostd::string_view{"postgres"}}, {"db.index", 3}};
+  std::map<std::string, opentelemetry::common::AttributeValue> other_index = {
+      {"db.system", nostd::string_view{"redis"}}, {"db.index", int64_t{3}}};
+  EXPECT_EQ(Decision::NOT_RECORD,
+            SampleSpan(sampler, "query", trace_api::SpanKind::kClient, redis));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE,
+            SampleSpan(sampler, "query", trace_api::SpanKind::kClient, postgres));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE,
+            SampleSpan(sampler, "query", trace_api::SpanKind::kClient, other_index));
+  EXPECT_EQ(Decision::RECORD_AND_SAMPLE,
+            SampleSpan(sampler, "other", trace_api::SpanKind::kClient, redis));
+}
@@ -0,0 +1,273 @@
+#include "opentelemetry/sdk/trace/arena_span_data.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
+#include "opentelemetry/sdk/trace/samplers/trace_id_ratio.h"
+#include "opentelemetry/sdk/trace/span_data_pool.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+#include "opentelemetry/trace/noop.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+
+namespace
+{
+std::atomic<size_t> num_allocations{0};
+}  // namespace
+
+// Count heap allocations, so that benchmarks can report them per span.
+void *operator new(size_t size)
+{
+  ++num_allocations;
+  auto result = std::malloc(size == 0 ? 1 : size);
+  if (result == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  ++num_allocations;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+/**
+ * Reports the number of heap allocations per iteration since it was created.
+ */
+class AllocationCounter
+{
+public:
+  explicit AllocationCounter(benchmark::State &state) noexcept
+      : state_(state), start_{num_allocations.load()}
+  {}
+
+  ~AllocationCounter()
+  {
+    state_.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(num_allocations.load() - start_), benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  benchmark::State &state_;
+  size_t start_;
+};
+
+/**
+ * A processor that discards spans when they end, so that only the span itself
+ * is measured.
+ */
+template <class T = SpanData>
+class DiscardingProcessor final : public SpanProcessor
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new T);
+  }
+
+  void OnStart(Recordable &span) noexcept override {}
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    benchmark::DoNotOptimize(span.get());
+  }
+
+  void ForceFlush(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+};
+
+const char *const kAttributeKeys[] = {"attr0", "attr1", "attr2", "attr3", "attr4",
+                                      "attr5", "attr6", "attr7", "attr8", "attr9"};
+
+/**
+ * Starts a span, sets 10 attributes on it and ends it.
+ */
+void RunSpanLifecycle(benchmark::State &state,
+                      std::shared_ptr<opentelemetry::trace::Tracer> tracer)
+{
+  AllocationCounter allocation_counter{state};
+  for (auto _ : state)
+  {
+    auto span = tracer->StartSpan("span");
+    for (int64_t i = 0; i < 10; ++i)
+    {
+      span->SetAttribute(kAttributeKeys[i], i);
+    }
+    span->End();
+  }
+}
+
+void BM_SpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<DiscardingProcessor<>>())};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_SpanLifecycle);
+
+void BM_SingleOwnerSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<DiscardingProcessor<>>(), SpanSynchronization::kSingleOwner)};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_SingleOwnerSpanLifecycle);
+
+/**
+ * A processor that recycles spans when they end.
+ */
+class RecyclingProcessor final : public SpanProcessor
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override { return pool_.MakeRecordable(); }
+
+  void OnStart(Recordable &span) noexcept override {}
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    pool_.Recycle(std::move(span));
+  }
+
+  void ForceFlush(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+private:
+  SpanDataPool pool_;
+};
+
+void BM_PooledSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<RecyclingProcessor>())};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_PooledSpanLifecycle);
+
+void BM_PooledStartEndSpan(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<RecyclingProcessor>())};
+  AllocationCounter allocation_counter{state};
+  for (auto _ : state)
+  {
+    tracer->StartSpan("span")->End();
+  }
+}
+
+BENCHMARK(BM_PooledStartEndSpan);
+
+void BM_OnePercentSampledSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<RecyclingProcessor>(), SpanSynchronization::kThreadSafe,
+                 InstrumentationLibrary::Get(""),
+                 std::make_shared<TraceIdRatioBasedSampler>(0.01))};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_OnePercentSampledSpanLifecycle);
+
+/**
+ * Runs the span lifecycle with deferred sampling, keeping only spans that
+ * end with an error, so that no span is materialized.
+ */
+void BM_DeferredSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<RecyclingProcessor>(), SpanSynchronization::kThreadSafe,
+                 InstrumentationLibrary::Get(""), std::make_shared<AlwaysOffSampler>(),
+                 [](std::chrono::nanoseconds, opentelemetry::trace::CanonicalCode status) {
+                   return status != opentelemetry::trace::CanonicalCode::OK;
+                 })};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_DeferredSpanLifecycle);
+
+void BM_NoopSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{new opentelemetry::trace::NoopTracer};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_NoopSpanLifecycle);
+
+const int kSpansPerThread = 10000;
+
+void StartEndSpansForThread(opentelemetry::trace::Tracer &tracer)
+{
+  for (int i = 0; i < kSpansPerThread; ++i)
+  {
+    tracer.StartSpan("span")->End();
+  }
+}
+
+/**
+ * Starts and ends kSpansPerThread spans on each of state.range(0) threads with
+ * the same tracer, so that the threads contend on the tracer and processor.
+ */
+void BM_ContendedStartEndSpan(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<RecyclingProcessor>())};
+  auto num_threads  = static_cast<int>(state.range(0));
+  int64_t num_spans = 0;
+  for (auto _ : state)
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.emplace_back(StartEndSpansForThread, std::ref(*tracer));
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+    num_spans += num_threads * kSpansPerThread;
+  }
+  state.SetItemsProcessed(num_spans);
+}
+
+BENCHMARK(BM_ContendedStartEndSpan)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+
+void BM_ArenaSpanLifecycle(benchmark::State &state)
+{
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer{
+      new Tracer(std::make_shared<DiscardingProcessor<ArenaSpanData>>())};
+  RunSpanLifecycle(state, tracer);
+}
+
+BENCHMARK(BM_ArenaSpanLifecycle);
+}  // namespace
+
+BENCHMARK_MAIN();
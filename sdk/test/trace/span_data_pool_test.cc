@@ -0,0 +1,102 @@
+#include "opentelemetry/sdk/trace/span_data_pool.h"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace opentelemetry::sdk::trace;
+
+TEST(SpanDataPool, RecyclesRecordables)
+{
+  SpanDataPool pool;
+  auto recordable = pool.MakeRecordable();
+  ASSERT_NE(nullptr, recordable);
+  recordable->SetName("span 1");
+  recordable->SetAttribute("attr1", 314159);
+  auto address = recordable.get();
+  pool.Recycle(std::move(recordable));
+
+  // The recordable is reused, but none of its data is.
+  recordable = pool.MakeRecordable();
+  EXPECT_EQ(address, recordable.get());
+  auto span_data = static_cast<SpanData *>(recordable.get());
+  EXPECT_EQ("", span_data->GetName());
+  EXPECT_EQ(0, span_data->GetAttributes().size());
+}
+
+TEST(SpanDataPool, RecycledRecordablesKeepTheirCapacity)
+{
+  SpanDataPool pool;
+  const std::string long_name(100, 'n');
+  const std::string long_description(100, 'd');
+  auto recordable = pool.MakeRecordable();
+  auto span_data  = static_cast<SpanData *>(recordable.get());
+  span_data->SetName(long_name);
+  span_data->SetStatus(opentelemetry::trace::CanonicalCode::UNKNOWN, long_description);
+  auto name_data        = span_data->GetName().data();
+  auto description_data = span_data->GetDescription().data();
+  pool.Recycle(std::move(recordable));
+
+  // Setting strings of the same length again reuses the recycled buffers.
+  recordable = pool.MakeRecordable();
+  ASSERT_EQ(span_data, recordable.get());
+  span_data->SetName(long_name);
+  span_data->SetStatus(opentelemetry::trace::CanonicalCode::UNKNOWN, long_description);
+  EXPECT_EQ(long_name, span_data->GetName());
+  EXPECT_EQ(name_data, span_data->GetName().data());
+  EXPECT_EQ(description_data, span_data->GetDescription().data());
+}
+
+TEST(SpanDataPool, RecyclesAcrossThreads)
+{
+  SpanDataPool pool;
+  const int n = 200;
+
+  // Recordables are made on one thread and recycled on another, like spans
+  // ended on request threads and exported on a worker thread.
+  std::vector<std::unique_ptr<Recordable>> recordables;
+  std::set<Recordable *> addresses;
+  std::thread{[&] {
+    for (int i = 0; i < n; ++i)
+    {
+      recordables.push_back(pool.MakeRecordable());
+      addresses.insert(recordables.back().get());
+    }
+  }}.join();
+  for (auto &recordable : recordables)
+  {
+    pool.Recycle(std::move(recordable));
+  }
+
+  // The recycling thread only keeps a bounded cache; the rest is shared.
+  auto shared_size = pool.GetSharedSize();
+  EXPECT_GT(shared_size, 0);
+
+  size_t num_reused = 0;
+  std::thread{[&] {
+    for (int i = 0; i < n; ++i)
+    {
+      recordables[i] = pool.MakeRecordable();
+      num_reused += addresses.count(recordables[i].get());
+    }
+  }}.join();
+  EXPECT_EQ(shared_size, num_reused);
+  EXPECT_EQ(0, pool.GetSharedSize());
+}
+
+TEST(SpanDataPool, MaxSize)
+{
+  SpanDataPool pool{10};
+  std::vector<std::unique_ptr<Recordable>> recordables;
+  for (int i = 0; i < 200; ++i)
+  {
+    recordables.push_back(pool.MakeRecordable());
+  }
+  for (auto &recordable : recordables)
+  {
+    pool.Recycle(std::move(recordable));
+  }
+  EXPECT_LE(pool.GetSharedSize(), 10);
+}
@@ -0,0 +1,118 @@
+#include "opentelemetry/sdk/trace/tail_sampling_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+const int kTracesPerThread = 200;
+const int kSpansPerTrace   = 10;
+
+/**
+ * A processor that discards the spans of kept traces.
+ */
+class DiscardingProcessor final : public SpanProcessor
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  void OnStart(Recordable &span) noexcept override {}
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    benchmark::DoNotOptimize(span.get());
+  }
+
+  void ForceFlush(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+};
+
+void EndTracesForThread(SpanProcessor &processor,
+                        int thread_index,
+                        std::atomic<uint64_t> &on_end_nanoseconds)
+{
+  // Recordables are created up front so that only OnEnd is timed. Every trace
+  // ends its root span last, after its children.
+  std::vector<std::unique_ptr<Recordable>> recordables;
+  recordables.reserve(kTracesPerThread * kSpansPerTrace);
+  for (int trace = 0; trace < kTracesPerThread; ++trace)
+  {
+    uint8_t trace_id[trace_api::TraceId::kSize] = {
+        static_cast<uint8_t>(thread_index), static_cast<uint8_t>(trace),
+        static_cast<uint8_t>(trace >> 8),   0,
+        0,                                  0,
+        0,                                  0,
+        0,                                  0,
+        0,                                  0,
+        0,                                  static_cast<uint8_t>(thread_index),
+        static_cast<uint8_t>(trace >> 8),   static_cast<uint8_t>(trace)};
+    uint8_t root_id[trace_api::SpanId::kSize] = {1};
+    for (int span = kSpansPerTrace - 1; span >= 0; --span)
+    {
+      uint8_t span_id[trace_api::SpanId::kSize] = {1, static_cast<uint8_t>(span)};
+      auto recordable                           = processor.MakeRecordable();
+      recordable->SetIds(trace_api::TraceId{trace_id}, trace_api::SpanId{span_id},
+                         span == 0 ? trace_api::SpanId{} : trace_api::SpanId{root_id});
+      recordable->SetDuration(std::chrono::microseconds(span));
+      recordables.push_back(std::move(recordable));
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto &recordable : recordables)
+  {
+    processor.OnEnd(std::move(recordable));
+  }
+  auto end = std::chrono::steady_clock::now();
+  on_end_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * Ends the spans of kTracesPerThread traces on each of state.range(0) threads
+ * and reports the average latency of a single call to OnEnd.
+ */
+void BM_TailSamplingProcessorOnEnd(benchmark::State &state)
+{
+  TailSamplingProcessor processor{std::unique_ptr<SpanProcessor>(new DiscardingProcessor)};
+  auto num_threads = static_cast<int>(state.range(0));
+  std::atomic<uint64_t> on_end_nanoseconds{0};
+  uint64_t num_spans = 0;
+  for (auto _ : state)
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.emplace_back(EndTracesForThread, std::ref(processor), i,
+                           std::ref(on_end_nanoseconds));
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+    num_spans += num_threads * kTracesPerThread * kSpansPerTrace;
+  }
+  state.SetItemsProcessed(num_spans);
+  state.counters["OnEnd_ns"] =
+      static_cast<double>(on_end_nanoseconds) / static_cast<double>(num_spans);
+}
+
+BENCHMARK(BM_TailSamplingProcessorOnEnd)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,268 @@
+#include "opentelemetry/sdk/trace/tail_sampling_processor.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace opentelemetry::sdk::trace;
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+/**
+ * The spans received by a MockSpanProcessor.
+ */
+struct MockProcessorState
+{
+  std::mutex mu;
+  std::vector<std::unique_ptr<SpanData>> spans_received;
+  size_t num_flushes   = 0;
+  size_t num_shutdowns = 0;
+
+  size_t GetSpanCount()
+  {
+    std::lock_guard<std::mutex> guard{mu};
+    return spans_received.size();
+  }
+};
+
+/**
+ * A mock processor that records the spans that end.
+ */
+class MockSpanProcessor final : public SpanProcessor
+{
+public:
+  explicit MockSpanProcessor(std::shared_ptr<MockProcessorState> state) noexcept : state_{state}
+  {}
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  void OnStart(Recordable &span) noexcept override {}
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    std::lock_guard<std::mutex> guard{state_->mu};
+    state_->spans_received.emplace_back(static_cast<SpanData *>(span.release()));
+  }
+
+  void ForceFlush(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {
+    std::lock_guard<std::mutex> guard{state_->mu};
+    ++state_->num_flushes;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {
+    std::lock_guard<std::mutex> guard{state_->mu};
+    ++state_->num_shutdowns;
+  }
+
+private:
+  std::shared_ptr<MockProcessorState> state_;
+};
+
+trace_api::TraceId MakeTraceId(uint8_t n)
+{
+  uint8_t buffer[trace_api::TraceId::kSize] = {n, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, n};
+  return trace_api::TraceId{buffer};
+}
+
+trace_api::SpanId MakeSpanId(uint8_t n)
+{
+  uint8_t buffer[trace_api::SpanId::kSize] = {0, 0, 0, 0, 0, 0, 0, n};
+  return trace_api::SpanId{buffer};
+}
+
+/**
+ * Start and end a span.
+ * @param parent the id of the parent span, or 0 for a root span
+ */
+void EndSpan(SpanProcessor &processor,
+             uint8_t trace,
+             uint8_t span,
+             uint8_t parent,
+             trace_api::CanonicalCode status   = trace_api::CanonicalCode::OK,
+             std::chrono::nanoseconds duration = std::chrono::milliseconds(1))
+{
+  auto recordable = processor.MakeRecordable();
+  processor.OnStart(*recordable);
+  recordable->SetIds(MakeTraceId(trace), MakeSpanId(span),
+                     parent == 0 ? trace_api::SpanId{} : MakeSpanId(parent));
+  recordable->SetStatus(status, "");
+  recordable->SetDuration(duration);
+  processor.OnEnd(std::move(recordable));
+}
+
+std::unique_ptr<TailSamplingProcessor> MakeProcessor(std::shared_ptr<MockProcessorState> &state,
+                                                     const TailSamplingProcessorOptions &options)
+{
+  return std::unique_ptr<TailSamplingProcessor>{new TailSamplingProcessor{
+      std::unique_ptr<SpanProcessor>{new MockSpanProcessor{state}}, options}};
+}
+
+TailSamplingProcessorOptions MakeOptions(std::shared_ptr<Sampler> sampler)
+{
+  TailSamplingProcessorOptions options;
+  options.sampler = std::move(sampler);
+  return options;
+}
+}  // namespace
+
+TEST(TailSamplingProcessor, DecidesWhenRootEnds)
+{
+  auto state     = std::make_shared<MockProcessorState>();
+  auto processor = MakeProcessor(state, MakeOptions(std::make_shared<AlwaysOnSampler>()));
+
+  EndSpan(*processor, 1, 2, 1);
+  EndSpan(*processor, 1, 3, 1);
+  EXPECT_EQ(0, state->GetSpanCount());
+  EXPECT_EQ(2, processor->GetBufferedSpanCount());
+
+  EndSpan(*processor, 1, 1, 0);
+  ASSERT_EQ(3, state->GetSpanCount());
+  EXPECT_EQ(0, processor->GetBufferedSpanCount());
+  for (auto &span : state->spans_received)
+  {
+    EXPECT_EQ(MakeTraceId(1), span->GetTraceId());
+  }
+}
+
+TEST(TailSamplingProcessor, KeepsErrorTraces)
+{
+  auto state     = std::make_shared<MockProcessorState>();
+  auto processor = MakeProcessor(state, MakeOptions(std::make_shared<AlwaysOffSampler>()));
+
+  EndSpan(*processor, 1, 2, 1, trace_api::CanonicalCode::INTERNAL);
+  EndSpan(*processor, 1, 1, 0);
+  EndSpan(*processor, 2, 2, 1);
+  EndSpan(*processor, 2, 1, 0);
+
+  ASSERT_EQ(2, state->GetSpanCount());
+  EXPECT_EQ(MakeTraceId(1), state->spans_received[0]->GetTraceId());
+  EXPECT_EQ(MakeTraceId(1), state->spans_received[1]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, KeepsSlowTraces)
+{
+  auto state     = std::make_shared<MockProcessorState>();
+  auto options   = MakeOptions(std::make_shared<AlwaysOffSampler>());
+  auto slow      = options.latency_threshold;
+  auto processor = MakeProcessor(state, options);
+
+  EndSpan(*processor, 1, 2, 1, trace_api::CanonicalCode::OK, slow);
+  EndSpan(*processor, 1, 1, 0);
+  EndSpan(*processor, 2, 1, 0, trace_api::CanonicalCode::OK, slow / 2);
+
+  ASSERT_EQ(2, state->GetSpanCount());
+  EXPECT_EQ(MakeTraceId(1), state->spans_received[0]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, DecidesQuietTraces)
+{
+  auto state            = std::make_shared<MockProcessorState>();
+  auto options          = MakeOptions(std::make_shared<AlwaysOnSampler>());
+  options.decision_wait = std::chrono::milliseconds(10);
+  auto processor        = MakeProcessor(state, options);
+
+  EndSpan(*processor, 1, 2, 1);
+  for (int i = 0; i < 1000 && state->GetSpanCount() == 0; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(1, state->GetSpanCount());
+}
+
+TEST(TailSamplingProcessor, EvictsOverBudget)
+{
+  auto state                 = std::make_shared<MockProcessorState>();
+  auto options               = MakeOptions(std::make_shared<AlwaysOnSampler>());
+  options.max_buffered_spans = 4;
+  options.num_shards         = 1;
+  auto processor             = MakeProcessor(state, options);
+
+  for (uint8_t trace = 1; trace <= 6; ++trace)
+  {
+    EndSpan(*processor, trace, 2, 1);
+  }
+
+  EXPECT_EQ(4, processor->GetBufferedSpanCount());
+  EXPECT_EQ(2, processor->GetEvictedTraceCount());
+  ASSERT_EQ(2, state->GetSpanCount());
+  EXPECT_EQ(MakeTraceId(1), state->spans_received[0]->GetTraceId());
+  EXPECT_EQ(MakeTraceId(2), state->spans_received[1]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, EvictsLeastRecentlyEndedTraces)
+{
+  auto state                 = std::make_shared<MockProcessorState>();
+  auto options               = MakeOptions(std::make_shared<AlwaysOnSampler>());
+  options.max_buffered_spans = 3;
+  options.num_shards         = 1;
+  auto processor             = MakeProcessor(state, options);
+
+  // Trace 1 started first, but trace 2 is the one that went quiet.
+  EndSpan(*processor, 1, 2, 1);
+  EndSpan(*processor, 2, 2, 1);
+  EndSpan(*processor, 1, 3, 1);
+  EndSpan(*processor, 3, 2, 1);
+
+  EXPECT_EQ(1, processor->GetEvictedTraceCount());
+  ASSERT_EQ(1, state->GetSpanCount());
+  EXPECT_EQ(MakeTraceId(2), state->spans_received[0]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, ForceFlushAndShutdown)
+{
+  auto state     = std::make_shared<MockProcessorState>();
+  auto processor = MakeProcessor(state, MakeOptions(std::make_shared<AlwaysOnSampler>()));
+
+  EndSpan(*processor, 1, 2, 1);
+  processor->ForceFlush();
+  EXPECT_EQ(1, state->GetSpanCount());
+  EXPECT_EQ(1, state->num_flushes);
+
+  EndSpan(*processor, 2, 2, 1);
+  processor->Shutdown();
+  EXPECT_EQ(2, state->GetSpanCount());
+  EXPECT_EQ(1, state->num_shutdowns);
+
+  // Spans ended after shutdown are dropped, and shutdown happens only once.
+  EndSpan(*processor, 3, 1, 0);
+  processor->Shutdown();
+  EXPECT_EQ(2, state->GetSpanCount());
+  EXPECT_EQ(1, state->num_shutdowns);
+}
+
+TEST(TailSamplingProcessor, ConcurrentTraces)
+{
+  auto state     = std::make_shared<MockProcessorState>();
+  auto processor = MakeProcessor(state, MakeOptions(std::make_shared<AlwaysOnSampler>()));
+
+  std::vector<std::thread> threads;
+  for (uint8_t thread = 1; thread <= 8; ++thread)
+  {
+    threads.emplace_back([&processor, thread] {
+      for (int i = 0; i < 100; ++i)
+      {
+        EndSpan(*processor, thread, 2, 1);
+        EndSpan(*processor, thread, 1, 0);
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(8 * 100 * 2, state->GetSpanCount());
+  EXPECT_EQ(0, processor->GetBufferedSpanCount());
+}
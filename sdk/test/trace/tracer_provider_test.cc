@@ -2,6 +2,9 @@
 #include "opentelemetry/sdk/trace/simple_processor.h"
 #include "opentelemetry/sdk/trace/tracer.h"
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace opentelemetry::sdk::trace;
@@ -14,16 +17,77 @@ TEST(TracerProvider, GetTracer)
   auto t1 = tf.GetTracer("test");
   auto t2 = tf.GetTracer("test");
   auto t3 = tf.GetTracer("different", "1.0.0");
+  auto t4 = tf.GetTracer("different", "2.0.0");
   ASSERT_NE(nullptr, t1);
   ASSERT_NE(nullptr, t2);
   ASSERT_NE(nullptr, t3);
+  ASSERT_NE(nullptr, t4);
 
-  // Should return the same instance each time.
+  // Should return the same instance for the same library.
   ASSERT_EQ(t1, t2);
-  ASSERT_EQ(t1, t3);
+  ASSERT_EQ(t3, tf.GetTracer("different", "1.0.0"));
+
+  // Should return a different instance for each library.
+  ASSERT_NE(t1, t3);
+  ASSERT_NE(t3, t4);
 
-  // Should be an sdk::trace::Tracer with the processor attached.
-  auto sdkTracer = dynamic_cast<Tracer *>(t1.get());
+  // Should be an sdk::trace::Tracer with the processor and library attached.
+  auto sdkTracer = dynamic_cast<Tracer *>(t3.get());
   ASSERT_NE(nullptr, sdkTracer);
   ASSERT_EQ(processor, sdkTracer->GetProcessor());
+  ASSERT_EQ("different", sdkTracer->GetInstrumentationLibrary().GetName());
+  ASSERT_EQ("1.0.0", sdkTracer->GetInstrumentationLibrary().GetVersion());
+}
+
+TEST(TracerProvider, SetProcessor)
+{
+  std::shared_ptr<SpanProcessor> processor1(new SimpleSpanProcessor(nullptr));
+  std::shared_ptr<SpanProcessor> processor2(new SimpleSpanProcessor(nullptr));
+
+  TracerProvider tf(processor1);
+  auto t1 = tf.GetTracer("test1");
+  auto t2 = tf.GetTracer("test2");
+
+  tf.SetProcessor(processor2);
+  ASSERT_EQ(processor2, tf.GetProcessor());
+  ASSERT_EQ(processor2, static_cast<Tracer *>(t1.get())->GetProcessor());
+  ASSERT_EQ(processor2, static_cast<Tracer *>(t2.get())->GetProcessor());
+
+  // Tracers created later use the new processor too.
+  auto t3 = tf.GetTracer("test3");
+  ASSERT_EQ(processor2, static_cast<Tracer *>(t3.get())->GetProcessor());
+}
+
+TEST(TracerProvider, ConcurrentGetTracer)
+{
+  std::shared_ptr<SpanProcessor> processor(new SimpleSpanProcessor(nullptr));
+  TracerProvider tf(processor);
+
+  const int kNumThreads   = 8;
+  const int kNumLibraries = 16;
+  std::vector<std::vector<opentelemetry::trace::Tracer *>> tracers(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i)
+  {
+    threads.emplace_back([&tf, &tracers, i] {
+      for (int library = 0; library < kNumLibraries; ++library)
+      {
+        tracers[i].push_back(tf.GetTracer("library", std::to_string(library)).get());
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  // All threads should see the same tracer for every library.
+  for (int library = 0; library < kNumLibraries; ++library)
+  {
+    auto tracer = tf.GetTracer("library", std::to_string(library)).get();
+    for (int i = 0; i < kNumThreads; ++i)
+    {
+      ASSERT_EQ(tracer, tracers[i][library]);
+    }
+  }
 }
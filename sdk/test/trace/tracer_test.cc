@@ -1,7 +1,10 @@
 #include "opentelemetry/sdk/trace/tracer.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
 #include "opentelemetry/sdk/trace/simple_processor.h"
 #include "opentelemetry/sdk/trace/span_data.h"
 
+#include <thread>
+
 #include <gtest/gtest.h>
 
 using namespace opentelemetry::sdk::trace;
@@ -49,12 +52,36 @@ private:
 namespace
 {
 std::shared_ptr<opentelemetry::trace::Tracer> initTracer(
-    std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> &received)
+    std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> &received,
+    SpanSynchronization span_synchronization = SpanSynchronization::kThreadSafe,
+    std::shared_ptr<Sampler> sampler         = std::make_shared<AlwaysOnSampler>())
 {
   std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(received));
   std::shared_ptr<SimpleSpanProcessor> processor(new SimpleSpanProcessor(std::move(exporter)));
-  return std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(processor));
+  return std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(
+      processor, span_synchronization, InstrumentationLibrary::Get(""), std::move(sampler)));
 }
+
+/**
+ * A sampler that records spans without sampling them, and adds an attribute.
+ */
+class RecordingSampler final : public Sampler
+{
+public:
+  SamplingResult ShouldSample(const opentelemetry::trace::SpanContext * /*parent_context*/,
+                              opentelemetry::trace::TraceId /*trace_id*/,
+                              nostd::string_view /*name*/,
+                              opentelemetry::trace::SpanKind /*span_kind*/,
+                              const opentelemetry::trace::KeyValueIterable & /*attributes*/) noexcept
+      override
+  {
+    std::unique_ptr<FlatAttributeMap> attributes{new FlatAttributeMap};
+    attributes->Set("sampler", "recording");
+    return {Decision::RECORD, std::move(attributes)};
+  }
+
+  std::string GetDescription() const noexcept override { return "RecordingSampler"; }
+};
 }  // namespace
 
 TEST(Tracer, ToMockSpanExporter)
@@ -92,6 +119,22 @@ TEST(Tracer, StartSpan)
   ASSERT_LT(std::chrono::nanoseconds(0), span_data->GetDuration());
 }
 
+TEST(Tracer, StartSpanWithInstrumentationLibrary)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(spans_received));
+  std::shared_ptr<SimpleSpanProcessor> processor(new SimpleSpanProcessor(std::move(exporter)));
+  auto &library = InstrumentationLibrary::Get("test", "1.0.0");
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer(
+      new Tracer(processor, SpanSynchronization::kThreadSafe, library));
+
+  tracer->StartSpan("span 1")->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  ASSERT_EQ(&library, spans_received->at(0)->GetInstrumentationLibrary());
+}
+
 TEST(Tracer, StartSpanWithOptionsTime)
 {
   std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
@@ -132,10 +175,262 @@ TEST(Tracer, StartSpanWithAttributes)
 
   auto &span_data = spans_received->at(0);
   ASSERT_EQ(2, span_data->GetAttributes().size());
-  ASSERT_EQ("string", nostd::get<nostd::string_view>(span_data->GetAttributes().at("attr1")));
-  ASSERT_EQ(false, nostd::get<bool>(span_data->GetAttributes().at("attr2")));
+  ASSERT_EQ("string",
+            nostd::get<nostd::string_view>(span_data->GetAttributes().Find("attr1")->Get()));
+  ASSERT_EQ(false, nostd::get<bool>(span_data->GetAttributes().Find("attr2")->Get()));
 
   auto &span_data2 = spans_received->at(1);
   ASSERT_EQ(1, span_data2->GetAttributes().size());
-  ASSERT_EQ(3.0, nostd::get<double>(span_data2->GetAttributes().at("attr3")));
+  ASSERT_EQ(3.0, nostd::get<double>(span_data2->GetAttributes().Find("attr3")->Get()));
+}
+
+TEST(Tracer, SpanIsRecordingUntilEnded)
+{
+  for (auto span_synchronization :
+       {SpanSynchronization::kThreadSafe, SpanSynchronization::kSingleOwner})
+  {
+    std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+        new std::vector<std::unique_ptr<SpanData>>);
+    auto tracer = initTracer(spans_received, span_synchronization);
+
+    auto span = tracer->StartSpan("span 1");
+    EXPECT_TRUE(span->IsRecording());
+    span->SetAttribute("attr1", 1);
+    span->End();
+    EXPECT_FALSE(span->IsRecording());
+
+    // Updates after the span ended are ignored, and it's only exported once.
+    span->SetAttribute("attr2", 2);
+    span->UpdateName("span 2");
+    span->End();
+
+    ASSERT_EQ(1, spans_received->size());
+    auto &span_data = spans_received->at(0);
+    EXPECT_EQ("span 1", span_data->GetName());
+    EXPECT_EQ(1, span_data->GetAttributes().size());
+  }
+}
+
+TEST(Tracer, ConcurrentSpanUpdates)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received);
+  auto span   = tracer->StartSpan("span 1");
+
+  const int num_threads = 4;
+  const int n           = 100;
+  std::vector<std::thread> threads;
+  for (int thread_index = 0; thread_index < num_threads; ++thread_index)
+  {
+    threads.emplace_back([&, thread_index] {
+      for (int i = 0; i < n; ++i)
+      {
+        span->SetAttribute("attr" + std::to_string(thread_index * n + i), i);
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  EXPECT_EQ(num_threads * n, spans_received->at(0)->GetAttributes().size());
+}
+
+TEST(Tracer, SpansMovedBetweenThreads)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received);
+
+  // Spans are started on a thread that exits before they're destroyed, so
+  // their memory is cached by another thread.
+  const int n = 100;
+  std::vector<nostd::unique_ptr<opentelemetry::trace::Span>> spans;
+  std::thread{[&] {
+    for (int i = 0; i < n; ++i)
+    {
+      spans.push_back(tracer->StartSpan("span " + std::to_string(i)));
+    }
+  }}.join();
+  spans.clear();
+  for (int i = 0; i < n; ++i)
+  {
+    tracer->StartSpan("span " + std::to_string(n + i));
+  }
+
+  ASSERT_EQ(2 * n, spans_received->size());
+  for (int i = 0; i < 2 * n; ++i)
+  {
+    EXPECT_EQ("span " + std::to_string(i), spans_received->at(i)->GetName());
+  }
+}
+
+TEST(Tracer, StartSpanSampleOff)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received, SpanSynchronization::kThreadSafe,
+                           std::make_shared<AlwaysOffSampler>());
+
+  auto span = tracer->StartSpan("span 1", {{"attr1", 314159}});
+  ASSERT_FALSE(span->IsRecording());
+  ASSERT_EQ(tracer.get(), &span->tracer());
+  span->SetAttribute("attr2", 1);
+  span->UpdateName("span 2");
+  span->End();
+
+  ASSERT_EQ(0, spans_received->size());
+}
+
+TEST(Tracer, StartSpanWithSamplingAttributes)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received, SpanSynchronization::kThreadSafe,
+                           std::make_shared<RecordingSampler>());
+
+  tracer->StartSpan("span 1", {{"attr1", 314159}})->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_TRUE(span_data->GetTraceId().IsValid());
+  ASSERT_TRUE(span_data->GetSpanId().IsValid());
+  ASSERT_EQ(2, span_data->GetAttributes().size());
+  ASSERT_EQ(314159, nostd::get<int>(span_data->GetAttributes().Find("attr1")->Get()));
+  ASSERT_EQ("recording",
+            nostd::get<nostd::string_view>(span_data->GetAttributes().Find("sampler")->Get()));
+}
+
+namespace
+{
+std::shared_ptr<opentelemetry::trace::Tracer> initDeferredTracer(
+    std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> &received)
+{
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(received));
+  std::shared_ptr<SimpleSpanProcessor> processor(new SimpleSpanProcessor(std::move(exporter)));
+  return std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(
+      processor, SpanSynchronization::kThreadSafe, InstrumentationLibrary::Get(""),
+      std::make_shared<AlwaysOffSampler>(),
+      [](std::chrono::nanoseconds duration, opentelemetry::trace::CanonicalCode status) {
+        return status != opentelemetry::trace::CanonicalCode::OK ||
+               duration >= std::chrono::seconds(1);
+      }));
+}
+}  // namespace
+
+TEST(Tracer, DeferredSamplingKeepsMatchingSpans)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initDeferredTracer(spans_received);
+
+  auto span = tracer->StartSpan("span 1", {{"attr1", 314159}});
+  ASSERT_TRUE(span->IsRecording());
+  span->SetAttribute("attr2", "value");
+  span->UpdateName("span 2");
+  span->SetStatus(opentelemetry::trace::CanonicalCode::INTERNAL, "failed");
+  ASSERT_EQ(0, spans_received->size());
+  span->End();
+  ASSERT_FALSE(span->IsRecording());
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_EQ("span 2", span_data->GetName());
+  ASSERT_TRUE(span_data->GetTraceId().IsValid());
+  ASSERT_TRUE(span_data->GetSpanId().IsValid());
+  ASSERT_FALSE(span_data->GetParentSpanId().IsValid());
+  ASSERT_EQ(opentelemetry::trace::CanonicalCode::INTERNAL, span_data->GetStatus());
+  ASSERT_EQ("failed", span_data->GetDescription());
+  ASSERT_LT(std::chrono::nanoseconds(0), span_data->GetStartTime().time_since_epoch());
+  ASSERT_EQ(2, span_data->GetAttributes().size());
+  ASSERT_EQ(314159, nostd::get<int>(span_data->GetAttributes().Find("attr1")->Get()));
+  ASSERT_EQ("value",
+            nostd::get<nostd::string_view>(span_data->GetAttributes().Find("attr2")->Get()));
+}
+
+TEST(Tracer, DeferredSamplingDropsOtherSpans)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initDeferredTracer(spans_received);
+
+  tracer->StartSpan("fast")->End();
+  ASSERT_EQ(0, spans_received->size());
+
+  opentelemetry::trace::StartSpanOptions options;
+  options.start_steady_time = SteadyTimestamp(std::chrono::steady_clock::now() -
+                                              std::chrono::seconds(2));
+  tracer->StartSpan("slow", options)->End();
+  ASSERT_EQ(1, spans_received->size());
+  ASSERT_EQ("slow", spans_received->at(0)->GetName());
+}
+
+TEST(Tracer, DeferredSamplingBoundsAttributes)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initDeferredTracer(spans_received);
+
+  auto span = tracer->StartSpan("span 1");
+  span->SetAttribute("attr1", 1);
+  span->SetAttribute("attr2", 2);
+  span->SetAttribute("attr3", 3);
+  span->SetAttribute("attr1", 10);
+  span->SetAttribute("attr4", 4);
+  span->SetAttribute("attr5", 5);
+  span->SetStatus(opentelemetry::trace::CanonicalCode::UNKNOWN, "");
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &attributes = spans_received->at(0)->GetAttributes();
+  ASSERT_EQ(4, attributes.size());
+  ASSERT_EQ(10, nostd::get<int>(attributes.Find("attr1")->Get()));
+  ASSERT_EQ(4, nostd::get<int>(attributes.Find("attr4")->Get()));
+  ASSERT_EQ(nullptr, attributes.Find("attr5"));
+}
+
+namespace
+{
+/**
+ * An id generator that returns the same ids every time.
+ */
+class FixedIdGenerator final : public IdGenerator
+{
+public:
+  opentelemetry::trace::TraceId GenerateTraceId() noexcept override
+  {
+    const uint8_t buffer[opentelemetry::trace::TraceId::kSize] = {1, 2, 3};
+    return opentelemetry::trace::TraceId{buffer};
+  }
+
+  opentelemetry::trace::SpanId GenerateSpanId() noexcept override
+  {
+    const uint8_t buffer[opentelemetry::trace::SpanId::kSize] = {4, 5, 6};
+    return opentelemetry::trace::SpanId{buffer};
+  }
+};
+}  // namespace
+
+TEST(Tracer, StartSpanWithIdGenerator)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(spans_received));
+  std::shared_ptr<SimpleSpanProcessor> processor(new SimpleSpanProcessor(std::move(exporter)));
+  auto id_generator = std::make_shared<FixedIdGenerator>();
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer(new Tracer(
+      processor, SpanSynchronization::kThreadSafe, InstrumentationLibrary::Get(""),
+      std::make_shared<AlwaysOnSampler>(), nullptr, id_generator));
+
+  tracer->StartSpan("span 1")->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_EQ(id_generator->GenerateTraceId(), span_data->GetTraceId());
+  ASSERT_EQ(id_generator->GenerateSpanId(), span_data->GetSpanId());
+  ASSERT_FALSE(span_data->GetParentSpanId().IsValid());
 }